@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Load time benchmark of main.edj on a plain Linux host, e.g. before and after tools/edc_prune.c.
+ * Every round opens each file cold as far as edje is concerned, the caches are flushed in between.
+ * "open" is edje reading the file and the group, "layout" is elm_layout_file_set() on a buffer window.
+ *
+ * Build, old.edj from the tree before the prune of 571502b with the image it removed:
+ *   mkdir -p old/images
+ *   git show 571502b^:res/edje/main.edc > old/main.edc
+ *   git show '571502b^:edje/images/dialer_fadeout.#.png' > 'old/images/dialer_fadeout.#.png'
+ *   edje_cc -id old/images -id edje/images old/main.edc old.edj
+ *   edje_cc -id edje/images res/edje/main.edc res/edje/main.edj
+ *   gcc -O2 -Iinc bench/edj_load_bench.c -o edj_load_bench $(pkg-config --cflags --libs elementary)
+ *
+ * Run:
+ *   ./edj_load_bench [-n rounds] old.edj res/edje/main.edj
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <Elementary.h>
+
+/* view.h needs this type from efl_extension which is not on the host */
+typedef void (*Eext_Event_Cb)(void *data, Evas_Object *obj, void *event_info);
+#include "catalog.h"
+#include "view.h"
+
+#define BENCH_FILES_MAX 8
+#define BENCH_ROUNDS_MAX 10000
+
+struct bench_file {
+	const char *path;
+	long size;
+	double open_ms[BENCH_ROUNDS_MAX];
+	double layout_ms[BENCH_ROUNDS_MAX];
+	int failed;
+};
+
+static struct bench_info {
+	Evas_Object *win;
+	struct bench_file files[BENCH_FILES_MAX];
+	int file_count;
+} s_info = {
+	.win = NULL,
+	.file_count = 0,
+};
+
+/*
+ * @brief Get monotonic time in seconds
+ */
+static double _time_get(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+static int _ms_cmp(const void *a, const void *b)
+{
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * @brief Open the file and build the layout of view_dialer_create() once, from cold edje caches
+ * @param[in] file File to be measured
+ * @param[in] round Round of the measurement
+ */
+static void _bench_round(struct bench_file *file, int round)
+{
+	Evas_Object *layout = NULL;
+	double start;
+
+	edje_file_cache_flush();
+	edje_collection_cache_flush();
+
+	start = _time_get();
+	if (!edje_file_group_exists(file->path, GRP_MAIN))
+		file->failed = 1;
+	file->open_ms[round] = (_time_get() - start) * 1000.0;
+
+	/* Group stays in the edje file cache, this is the layout on its own */
+	layout = elm_layout_add(s_info.win);
+	start = _time_get();
+	if (!elm_layout_file_set(layout, file->path, GRP_MAIN))
+		file->failed = 1;
+	evas_object_resize(layout, 360, 360);
+	evas_object_show(layout);
+	edje_object_calc_force(elm_layout_edje_get(layout));
+	file->layout_ms[round] = (_time_get() - start) * 1000.0;
+
+	evas_object_del(layout);
+}
+
+/*
+ * @brief Print the results of the file
+ * @param[in] file File measured
+ * @param[in] rounds Number of rounds
+ */
+static void _bench_report(struct bench_file *file, int rounds)
+{
+	if (file->failed) {
+		printf("%s: failed to load group \"%s\"\n", file->path, GRP_MAIN);
+		return;
+	}
+
+	qsort(file->open_ms, rounds, sizeof(double), _ms_cmp);
+	qsort(file->layout_ms, rounds, sizeof(double), _ms_cmp);
+
+	printf("%s\n", file->path);
+	printf("  size %ld bytes\n", file->size);
+	printf("  open ms min %.3f p50 %.3f p95 %.3f\n", file->open_ms[0], file->open_ms[rounds / 2], file->open_ms[rounds * 95 / 100]);
+	printf("  layout ms min %.3f p50 %.3f p95 %.3f\n", file->layout_ms[0], file->layout_ms[rounds / 2], file->layout_ms[rounds * 95 / 100]);
+}
+
+int main(int argc, char *argv[])
+{
+	struct stat st;
+	int rounds = 200;
+	int opt;
+	int i, k;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		switch (opt) {
+		case 'n':
+			rounds = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-n rounds] file.edj ...\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind >= argc || rounds < 1 || rounds > BENCH_ROUNDS_MAX) {
+		fprintf(stderr, "usage: %s [-n rounds] file.edj ...\n", argv[0]);
+		return 1;
+	}
+
+	for (i = optind; i < argc && s_info.file_count < BENCH_FILES_MAX; i++) {
+		s_info.files[s_info.file_count].path = argv[i];
+		s_info.files[s_info.file_count].size = stat(argv[i], &st) ? -1 : (long)st.st_size;
+		s_info.file_count++;
+	}
+
+	/* No display on the host, the window renders into a buffer */
+	setenv("ELM_ENGINE", "buffer", 1);
+	elm_init(argc, argv);
+
+	s_info.win = elm_win_add(NULL, "edj_load_bench", ELM_WIN_BASIC);
+	if (s_info.win == NULL) {
+		fprintf(stderr, "failed to create a window\n");
+		elm_shutdown();
+		return 1;
+	}
+	evas_object_resize(s_info.win, 360, 360);
+
+	/* Files take turns so that both see the same machine state */
+	for (k = 0; k < rounds; k++)
+		for (i = 0; i < s_info.file_count; i++)
+			_bench_round(&s_info.files[i], k);
+
+	for (i = 0; i < s_info.file_count; i++)
+		_bench_report(&s_info.files[i], rounds);
+
+	evas_object_del(s_info.win);
+	elm_shutdown();
+
+	return 0;
+}
@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Offscreen render benchmark of the main scene on a plain Linux host.
+ * The widget tree is the one of view_create() and view_dialer_create(): window, conformant,
+ * elm_layout of main.edj and elm_entry in "sw.entry.dial", on the buffer engine of Elementary.
+ *
+ * Build:
+ *   edje_cc -id edje/images res/edje/main.edc res/edje/main.edj
+ *   gcc -O2 -Iinc bench/render_bench.c src/plate.c -o render_bench $(pkg-config --cflags --libs elementary)
+ *
+ * Run:
+ *   ./render_bench [-e main.edj] [-i res/images] [-x gip] [-n iterations]
+ *                  [-c image_cache_bytes] [-t entry|textblock|text]
+ * All images are read from the -i directory, the greeting background dialer_button_bg.png too.
+ * Level plates are indexed, -x png times decoding their source PNGs of tools/plates instead,
+ * from a directory with both, e.g.
+ *   mkdir png && cp tools/plates/*.png res/images/dialer_button_bg.png png/ && ./render_bench -i png -x png
+ * Expanding an indexed plate counts as render time, as the PNG decode of the first render does.
+ * -t swaps the entry of the app for a bare textblock or text object to compare text widgets.
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <Elementary.h>
+
+/* view.h needs this type from efl_extension which is not on the host */
+typedef void (*Eext_Event_Cb)(void *data, Evas_Object *obj, void *event_info);
+#include "catalog.h"
+#include "view.h"
+#include "plate.h"
+
+#define BENCH_W 360
+#define BENCH_H 360
+#define BENCH_LEVELS 20
+
+typedef enum {
+	BENCH_TEXT_ENTRY = 0,
+	BENCH_TEXT_TEXTBLOCK,
+	BENCH_TEXT_TEXT
+} bench_text_e;
+
+static struct bench_info {
+	Evas_Object *win;
+	Evas *evas;
+	Evas_Object *layout;
+	Evas_Object *text;
+	Evas_Textblock_Style *style;
+	const char *entry_style;
+	bench_text_e text_mode;
+
+	const char *image_dir;
+	const char *image_ext;
+
+	double render_time;
+	unsigned long long pixels;
+	int frames;
+} s_info = {
+	.win = NULL,
+	.evas = NULL,
+	.layout = NULL,
+	.text = NULL,
+	.style = NULL,
+	.entry_style = NULL,
+	.text_mode = BENCH_TEXT_ENTRY,
+
+	.image_dir = "res/images",
+	.image_ext = "gip",
+
+	.render_time = 0.0,
+	.pixels = 0,
+	.frames = 0,
+};
+
+/*
+ * @brief Get monotonic time in seconds
+ */
+static double _time_get(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/*
+ * @brief Render the canvas and account time and updated pixels of the frame
+ */
+static void _bench_render(void)
+{
+	Eina_List *updates = NULL;
+	Eina_List *l = NULL;
+	Eina_Rectangle *r = NULL;
+	double start;
+
+	/* Jobs of the widgets run as in the main loop, the window itself never renders */
+	ecore_main_loop_iterate();
+
+	start = _time_get();
+	/* Deliver pending edje signals and messages as the main loop would */
+	edje_message_signal_process();
+	updates = evas_render_updates(s_info.evas);
+	s_info.render_time += _time_get() - start;
+
+	EINA_LIST_FOREACH(updates, l, r)
+		s_info.pixels += (unsigned long long)r->w * r->h;
+
+	evas_render_updates_free(updates);
+	s_info.frames++;
+}
+
+/*
+ * @brief Set status text the way view_dialer_set_entry_text() and _dialer_text_resize() do, restyling by length
+ * @param[in] text Status text
+ */
+static void _bench_set_text(const char *text)
+{
+	int len = strlen(text);
+	const char *style = DIAL_TEXT_STYLE_NORMAL;
+
+	if (len >= 15)
+		style = DIAL_TEXT_STYLE_SMALLER;
+	else if (len >= 10)
+		style = DIAL_TEXT_STYLE_SMALL;
+
+	switch (s_info.text_mode) {
+	case BENCH_TEXT_ENTRY:
+		elm_object_text_set(s_info.text, text);
+		if (style != s_info.entry_style) {
+			elm_entry_text_style_user_pop(s_info.text);
+			elm_entry_text_style_user_push(s_info.text, style);
+			s_info.entry_style = style;
+		}
+		elm_entry_cursor_end_set(s_info.text);
+		break;
+	case BENCH_TEXT_TEXTBLOCK:
+		evas_textblock_style_set(s_info.style, style);
+		evas_object_textblock_style_set(s_info.text, s_info.style);
+		evas_object_textblock_text_markup_set(s_info.text, text);
+		break;
+	default:
+		evas_object_text_font_set(s_info.text, "Tizen:style=Light", len >= 15 ? 23 : (len >= 10 ? 28 : 34));
+		evas_object_text_text_set(s_info.text, text);
+		break;
+	}
+}
+
+/*
+ * @brief Get the object in "sw.button.bg" for the plate, replaced when the other kind is needed
+ * PNG plates go to an elm_image as in view_set_image(), indexed plates to a tagged evas image
+ * @param[in] indexed Whether the plate is indexed
+ */
+static Evas_Object *_bench_plate_object(int indexed)
+{
+	Evas_Object *image = elm_object_part_content_get(s_info.layout, "sw.button.bg");
+
+	if (image && (evas_object_data_get(image, VIEW_PLATE_INDEXED_KEY) != NULL) == indexed)
+		return image;
+
+	if (image) {
+		elm_object_part_content_unset(s_info.layout, "sw.button.bg");
+		evas_object_del(image);
+	}
+
+	if (indexed) {
+		image = evas_object_image_filled_add(s_info.evas);
+		evas_object_data_set(image, VIEW_PLATE_INDEXED_KEY, image);
+		evas_object_image_alpha_set(image, EINA_TRUE);
+	} else {
+		image = elm_image_add(s_info.layout);
+	}
+	elm_object_part_content_set(s_info.layout, "sw.button.bg", image);
+
+	return image;
+}
+
+/*
+ * @brief Swap the plate of the given level the way view_dialer_set_plate() does
+ * @param[in] level Level of the plate, 0 is the greeting background
+ */
+static void _bench_set_plate(int level)
+{
+	char path[PATH_MAX] = { 0, };
+	Evas_Object *image = NULL;
+	unsigned int *pixels = NULL;
+	plate_s plate;
+	double start;
+
+	/* Greeting background is not indexed */
+	if (level == 0)
+		snprintf(path, sizeof(path), "%s/dialer_button_bg.png", s_info.image_dir);
+	else
+		snprintf(path, sizeof(path), "%s/lv%d.%s", s_info.image_dir, level, s_info.image_ext);
+
+	if (!plate_path_is_indexed(path)) {
+		if (!elm_image_file_set(_bench_plate_object(0), path, NULL))
+			fprintf(stderr, "failed to load %s\n", path);
+		return;
+	}
+
+	start = _time_get();
+	if (plate_open(&plate, path)) {
+		fprintf(stderr, "failed to load %s\n", path);
+		return;
+	}
+
+	/* Same as view_dialer_set_plate(), the image data is written in place */
+	image = _bench_plate_object(1);
+	evas_object_image_size_set(image, plate.header->width, plate.header->height);
+	pixels = evas_object_image_data_get(image, EINA_TRUE);
+	if (pixels) {
+		plate_expand(&plate, 0, pixels, evas_object_image_stride_get(image) / (int)sizeof(*pixels));
+		evas_object_image_data_set(image, pixels);
+		evas_object_image_data_update_add(image, 0, 0, plate.header->width, plate.header->height);
+	}
+	plate_close(&plate);
+	s_info.render_time += _time_get() - start;
+}
+
+/*
+ * @brief Create the status text in "sw.entry.dial", an entry set up as view_create_entry() does
+ */
+static void _bench_text_create(void)
+{
+	switch (s_info.text_mode) {
+	case BENCH_TEXT_ENTRY:
+		s_info.text = elm_entry_add(s_info.layout);
+		evas_object_size_hint_weight_set(s_info.text, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+		elm_entry_single_line_set(s_info.text, EINA_TRUE);
+		elm_entry_scrollable_set(s_info.text, EINA_TRUE);
+		elm_entry_input_panel_enabled_set(s_info.text, EINA_FALSE);
+		elm_entry_editable_set(s_info.text, EINA_FALSE);
+		elm_entry_context_menu_disabled_set(s_info.text, EINA_TRUE);
+		elm_entry_text_style_user_push(s_info.text, DIAL_TEXT_STYLE_NORMAL);
+		s_info.entry_style = DIAL_TEXT_STYLE_NORMAL;
+		break;
+	case BENCH_TEXT_TEXTBLOCK:
+		s_info.text = evas_object_textblock_add(s_info.evas);
+		s_info.style = evas_textblock_style_new();
+		break;
+	default:
+		s_info.text = evas_object_text_add(s_info.evas);
+		break;
+	}
+
+	elm_object_part_content_set(s_info.layout, "sw.entry.dial", s_info.text);
+}
+
+/*
+ * @brief Build the widget tree of view_create() and view_dialer_create() on a buffer window
+ * @param[in] edj_path Path of main.edj
+ */
+static int _bench_scene_create(const char *edj_path)
+{
+	Evas_Object *conform = NULL;
+
+	s_info.win = elm_win_add(NULL, "render_bench", ELM_WIN_BASIC);
+	if (s_info.win == NULL) {
+		fprintf(stderr, "failed to create a window\n");
+		return -1;
+	}
+	evas_object_resize(s_info.win, BENCH_W, BENCH_H);
+
+	/* Frames are rendered by _bench_render() only, never by the main loop */
+	s_info.evas = evas_object_evas_get(s_info.win);
+	ecore_evas_manual_render_set(ecore_evas_ecore_evas_get(s_info.evas), EINA_TRUE);
+
+	conform = elm_conformant_add(s_info.win);
+	evas_object_size_hint_weight_set(conform, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+	elm_win_resize_object_add(s_info.win, conform);
+	evas_object_show(conform);
+
+	s_info.layout = elm_layout_add(conform);
+	if (!elm_layout_file_set(s_info.layout, edj_path, GRP_MAIN)) {
+		fprintf(stderr, "failed to load %s\n", edj_path);
+		return -1;
+	}
+	evas_object_size_hint_weight_set(s_info.layout, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+	evas_object_show(s_info.layout);
+	elm_object_content_set(conform, s_info.layout);
+
+	_bench_text_create();
+	evas_object_show(s_info.win);
+
+	_bench_set_plate(0);
+	_bench_set_text("Type any color to start");
+	_bench_render();
+
+	return 0;
+}
+
+/*
+ * @brief Free the scene
+ */
+static void _bench_scene_destroy(void)
+{
+	if (s_info.win)
+		evas_object_del(s_info.win);
+
+	if (s_info.style)
+		evas_textblock_style_free(s_info.style);
+}
+
+/*
+ * @brief Replay a whole game: every level transition, then a miss and a full clear
+ */
+static void _bench_run_game(void)
+{
+	char text[100] = { 0, };
+	int level;
+
+	for (level = 1; level <= BENCH_LEVELS; level++) {
+		_bench_set_plate(level);
+		_bench_render();
+
+		snprintf(text, sizeof(text), "Level %d", level);
+		_bench_set_text(text);
+		_bench_render();
+	}
+
+	snprintf(text, sizeof(text), "Your Score: %d", BENCH_LEVELS / 2);
+	_bench_set_text(text);
+	_bench_render();
+
+	_bench_set_text("Good Eye!");
+	_bench_render();
+
+	_bench_set_plate(0);
+	_bench_render();
+}
+
+int main(int argc, char *argv[])
+{
+	const char *edj_path = "res/edje/main.edj";
+	int iterations = 100;
+	int cache = -1;
+	int opt;
+	int i;
+	struct rusage usage;
+
+	while ((opt = getopt(argc, argv, "e:i:x:n:c:t:")) != -1) {
+		switch (opt) {
+		case 'e':
+			edj_path = optarg;
+			break;
+		case 'i':
+			s_info.image_dir = optarg;
+			break;
+		case 'x':
+			s_info.image_ext = optarg;
+			break;
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		case 'c':
+			cache = atoi(optarg);
+			break;
+		case 't':
+			if (!strcmp(optarg, "textblock"))
+				s_info.text_mode = BENCH_TEXT_TEXTBLOCK;
+			else if (!strcmp(optarg, "text"))
+				s_info.text_mode = BENCH_TEXT_TEXT;
+			else
+				s_info.text_mode = BENCH_TEXT_ENTRY;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-e edj] [-i image_dir] [-x ext] [-n iterations] [-c cache_bytes] [-t entry|textblock|text]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	/* No display on the host, the window renders into a buffer */
+	setenv("ELM_ENGINE", "buffer", 1);
+	elm_init(argc, argv);
+
+	if (_bench_scene_create(edj_path) == 0) {
+		if (cache >= 0)
+			evas_image_cache_set(s_info.evas, cache);
+
+		/* Scene creation is not part of the numbers */
+		s_info.render_time = 0.0;
+		s_info.pixels = 0;
+		s_info.frames = 0;
+
+		for (i = 0; i < iterations; i++)
+			_bench_run_game();
+
+		getrusage(RUSAGE_SELF, &usage);
+		printf("frames %d\n", s_info.frames);
+		printf("ms/frame %.3f\n", s_info.frames ? s_info.render_time * 1000.0 / s_info.frames : 0.0);
+		printf("pixels/frame %llu\n", s_info.frames ? s_info.pixels / s_info.frames : 0);
+		printf("peak rss %ld kB\n", usage.ru_maxrss);
+	}
+
+	_bench_scene_destroy();
+	elm_shutdown();
+
+	return 0;
+}
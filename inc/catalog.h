@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+#if !defined(_CATALOG_H)
+#define _CATALOG_H
+
+/* Compiled catalogs in the resource directory, e.g. locale/ko_KR.cat or locale/ko.cat */
+#define CATALOG_DIR "locale/"
+#define CATALOG_SUFFIX ".cat"
+
+#define CATALOG_MAGIC 0x54434547 /* "GECT" */
+#define CATALOG_VERSION 1
+
+/* Numeric slot in a compiled string, followed by the argument number from '0' */
+#define CATALOG_SLOT '\x01'
+#define CATALOG_ARGS_MAX 2
+
+/*
+ * Every status string: id, key in the catalog source and the built-in English text.
+ * Built-in text is in the compiled form, "{0}" of the source is CATALOG_SLOT followed by '0'
+ */
+#define CATALOG_STRINGS(X) \
+	X(CATALOG_STR_GREETING, "greeting", "Type any color to start") \
+	X(CATALOG_STR_LEVEL, "level", "Level \x01" "0") \
+	X(CATALOG_STR_SCORE, "score", "Your Score: \x01" "0") \
+	X(CATALOG_STR_CLEAR, "clear", "Good Eye!") \
+	X(CATALOG_STR_LEVEL_TIME, "level_time", "Level \x01" "0 - \x01" "1s") \
+	X(CATALOG_STR_TIME_SCORE, "time_score", "Time Score: \x01" "0")
+
+typedef enum {
+#define CATALOG_ID(id, key, text) id,
+	CATALOG_STRINGS(CATALOG_ID)
+#undef CATALOG_ID
+	CATALOG_STR_COUNT
+} catalog_str_e;
+
+/*
+ * File layout, in the byte order of the device:
+ * header, one entry per string in the order of CATALOG_STRINGS, then NUL terminated texts.
+ * Texts are already escaped for the entry markup
+ */
+typedef struct {
+	unsigned int magic;
+	unsigned short version;
+	unsigned short count;
+} catalog_header_s;
+
+typedef struct {
+	unsigned int offset;
+	unsigned short length;
+	unsigned short slots;
+} catalog_entry_s;
+
+int catalog_load(const char *path);
+void catalog_reset(void);
+void catalog_shutdown(void);
+const char *catalog_get(catalog_str_e id);
+int catalog_format(char *buf, int len, catalog_str_e id, int a, int b);
+#endif
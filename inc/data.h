@@ -17,6 +17,39 @@
 #if !defined(_DATA_H)
 #define _DATA_H
 
+/* Progress log in the data directory, fixed size checksummed records */
+#define DATA_PROGRESS_FILE "progress.log"
+#define DATA_PROGRESS_TMP_FILE "progress.log.tmp"
+/* Rewrite the log with the latest record only once it grows past this */
+#define DATA_PROGRESS_COMPACT_RECORDS 4096
+/* After a failed compaction records are appended as usual, it is tried again this many records later */
+#define DATA_PROGRESS_COMPACT_RETRY_RECORDS 256
+/* Records written within this many seconds share one fsync */
+#define DATA_PROGRESS_SYNC_INTERVAL 1
+/* Recovery reads this many records from the end at a time */
+#define DATA_PROGRESS_TAIL_RECORDS 64
+
+/* Leaderboard and per-level timing histograms, memory mapped */
+#define DATA_STATS_FILE "stats.db"
+#define DATA_STATS_SCORE_MAX 100
+#define DATA_STATS_LEVEL_MAX 100
+/* Reaction time buckets, quarter octaves from DATA_STATS_TIME_BASE_MS */
+#define DATA_STATS_TIME_BUCKETS 48
+#define DATA_STATS_TIME_BASE_MS 32
+
+/*
+ * Every completed run, fixed size checksummed records appended by the progress writer.
+ * Queries above read the histograms of stats.db only, this log is never scanned by them.
+ */
+#define DATA_RUNS_FILE "runs.log"
+/* Runs waiting for the writer, game overs are seconds apart */
+#define DATA_RUNS_QUEUE_SIZE 8
+
+/* Runtime stats dumps, one JSON object per line */
+/* Longest output of data_stats_json_get(), every median and histogram bucket at its widest */
+#define DATA_STATS_JSON_MAX (128 + DATA_STATS_LEVEL_MAX * 12 + DATA_STATS_TIME_BUCKETS * 11)
+#define DATA_STATS_DUMP_FILE "stats.jsonl"
+
 /*
  * Initialize the data component
  */
@@ -28,7 +61,22 @@ void data_initialize(void);
 void data_finalize(void);
 
 void data_get_full_path(const char *file_path, char *full_path, int path_max);
+void data_get_data_path(const char *file_name, char *full_path, int path_max);
 char *data_get_image_path(const char *part_name);
-char *data_get_level_full_image_path(const char *path);
+void data_get_level_image_path(const char *file_name, char *full_path, int path_max);
+int data_get_rss_kb(void);
+
+void data_progress_get(int *level, int *best_score);
+void data_progress_save(int level, int best_score);
+
+void data_stats_add_run(int score, const unsigned int *level_times_ms, int level_count);
+unsigned int data_stats_runs_get(void);
+int data_stats_top_scores_get(int *scores, int n);
+double data_stats_score_percentile_get(int score);
+int data_stats_level_median_get(int level);
+int data_stats_run_count_get(void);
+int data_stats_run_get(int index, int *score, unsigned int *level_times_ms, int level_count);
+int data_stats_json_get(char *buf, int len, int level_count);
+int data_stats_dump_append(const char *line);
 #endif
 
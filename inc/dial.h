@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+#if !defined(_DIAL_H)
+#define _DIAL_H
+
+/* Dial geometry on the 360 x 360 screen, sectors go clockwise from the top */
+#define RADIUS_MIN 82
+#define CENTER_REF_X 180
+#define CENTER_REF_Y 180
+
+/*
+ * Dial layouts: id, sectors, radius of the ring split or 0 for a single ring.
+ * Sectors go clockwise from the top, sector 0 is centred on top. With a ring split, sector n of the
+ * inner ring is n and of the outer ring is sectors + n. Each layout gets its own classifier in
+ * src/dial.c with the boundaries folded to constants by the compiler. The plate of a level must be
+ * drawn for its layout, the first one is the classic dial every plate has now.
+ */
+#define DIAL_LAYOUTS(X) \
+	X(DIAL_LAYOUT_10, 10, 0) \
+	X(DIAL_LAYOUT_8, 8, 0) \
+	X(DIAL_LAYOUT_12, 12, 0) \
+	X(DIAL_LAYOUT_16, 16, 0) \
+	X(DIAL_LAYOUT_8_RING, 8, DIAL_RING_SPLIT) \
+	X(DIAL_LAYOUT_12_RING, 12, DIAL_RING_SPLIT)
+
+#define DIAL_RING_SPLIT ((RADIUS_MIN + CENTER_REF_X) / 2)
+
+/* Sectors of a ring are at most this, a layout has at most twice this targets */
+#define DIAL_LAYOUT_SECTORS_MAX 16
+#define DIAL_LAYOUT_TARGETS_MAX (2 * DIAL_LAYOUT_SECTORS_MAX)
+
+typedef enum {
+#define DIAL_LAYOUT_ID(id, sectors, ring) id,
+	DIAL_LAYOUTS(DIAL_LAYOUT_ID)
+#undef DIAL_LAYOUT_ID
+	DIAL_LAYOUT_COUNT
+} dial_layout_e;
+
+/* Sectors of the classic layout, the one of the analytics below */
+#define DIAL_SECTOR_COUNT 10
+/* Touch feedback is centred halfway between RADIUS_MIN and the edge */
+#define DIAL_SECTOR_CENTER_RADIUS ((RADIUS_MIN + CENTER_REF_X) / 2.0)
+
+/* Polar heatmap, rings of DIAL_HEAT_RADIUS_STEP pixels from the centre, the last one takes the rest */
+#define DIAL_HEAT_RADIUS_BINS 32
+#define DIAL_HEAT_RADIUS_STEP 8
+/* Angle bins of 3 degrees, bin 0 starts at the left edge of sector 0 so every sector has whole bins */
+#define DIAL_HEAT_ANGLE_BINS 120
+#define DIAL_HEAT_SECTOR_BINS (DIAL_HEAT_ANGLE_BINS / DIAL_SECTOR_COUNT)
+
+/* Points are classified in chunks of this many on the stack */
+#define DIAL_BATCH_CHUNK 1024
+
+typedef struct {
+	unsigned int bins[DIAL_HEAT_RADIUS_BINS][DIAL_HEAT_ANGLE_BINS];
+	unsigned long long points;
+} dial_heat_s;
+
+/* Row and column 0 are "no sector", sector n is at n + 1 */
+typedef struct {
+	unsigned int cells[DIAL_SECTOR_COUNT + 1][DIAL_SECTOR_COUNT + 1];
+} dial_confusion_s;
+
+int dial_layout_sector_get(dial_layout_e layout, int x, int y);
+int dial_layout_targets_get(dial_layout_e layout);
+int dial_layout_center_get(dial_layout_e layout, int target, double *x, double *y);
+int dial_sector_get(int x, int y);
+void dial_sector_batch(const int *x, const int *y, signed char *sector, int n);
+void dial_polar_batch(const int *x, const int *y, unsigned short *bin, int n);
+void dial_heat_add(dial_heat_s *heat, const int *x, const int *y, int n);
+void dial_confusion_add(dial_confusion_s *confusion, const signed char *row, const signed char *col, int n);
+#endif
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+#if !defined(_FEEDBACK_H)
+#define _FEEDBACK_H
+
+/* Mixed output is 16 bit signed mono */
+#define FEEDBACK_RATE 16000
+/* Frames per write, 16 ms at FEEDBACK_RATE */
+#define FEEDBACK_PERIOD 256
+/* Longest cue, 250 ms at FEEDBACK_RATE */
+#define FEEDBACK_CUE_FRAMES_MAX 4000
+#define FEEDBACK_VOICES 4
+/* Must be power of 2 */
+#define FEEDBACK_RING_SIZE 16
+
+/* Raw PCM written by the file sink in the data directory */
+#define FEEDBACK_FILE "feedback.pcm"
+
+typedef enum {
+	FEEDBACK_CUE_TAP = 0,
+	FEEDBACK_CUE_RIGHT,
+	FEEDBACK_CUE_WRONG,
+	FEEDBACK_CUE_MAX
+} feedback_cue_e;
+
+typedef enum {
+	FEEDBACK_SINK_NULL = 0,
+	FEEDBACK_SINK_FILE,
+	FEEDBACK_SINK_AUDIO_IO,
+	FEEDBACK_SINK_MAX
+} feedback_sink_e;
+
+int feedback_start(feedback_sink_e sink, const char *path);
+void feedback_stop(void);
+void feedback_play(feedback_cue_e cue);
+unsigned int feedback_played_get(void);
+unsigned int feedback_dropped_get(void);
+double feedback_latency_max_get(void);
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+#if !defined(_PERF_H)
+#define _PERF_H
+
+/* Startup milestones */
+typedef enum {
+	PERF_MARK_PROCESS_START = 0,
+	PERF_MARK_APP_CREATE,
+	PERF_MARK_FIRST_RENDER,
+	PERF_MARK_INTERACTIVE,
+	PERF_MARK_MAX
+} perf_mark_e;
+
+/* Callbacks timed by the stall watchdog */
+typedef enum {
+	PERF_CB_LOOP = 0,
+	PERF_CB_RENDER,
+	PERF_CB_MOUSE_DOWN,
+	PERF_CB_MOUSE_UP,
+	PERF_CB_MOUSE_MOVE,
+	PERF_CB_LONGPRESS,
+	PERF_CB_TEXT_RESIZE,
+	PERF_CB_APP_CREATE,
+	PERF_CB_APP_CONTROL,
+	PERF_CB_APP_PAUSE,
+	PERF_CB_APP_RESUME,
+	PERF_CB_APP_TERMINATE,
+	PERF_CB_LANG_CHANGED,
+	PERF_CB_LOW_MEMORY,
+	PERF_CB_FRAME,
+	PERF_CB_MAX
+} perf_cb_e;
+
+/* Main loop wakeups and renders since start, for battery regression tests */
+typedef struct {
+	unsigned int wakeups;
+	unsigned int renders;
+	double time;
+} perf_activity_s;
+
+/* Anything longer than one frame is a stall */
+#define PERF_STALL_THRESHOLD 0.016
+/* Must be power of 2 */
+#define PERF_STALL_RING_SIZE 64
+
+double perf_time_get(void);
+void perf_mark(perf_mark_e mark);
+void perf_mark_process_start(void);
+double perf_mark_get(perf_mark_e mark);
+void perf_startup_report(void);
+
+double perf_cb_enter(void);
+void perf_cb_leave(perf_cb_e id, double start);
+void perf_watchdog_start(Evas *evas);
+void perf_watchdog_stop(void);
+int perf_stall_count_get(void);
+void perf_activity_get(perf_activity_s *activity);
+void perf_activity_report(const char *what, const perf_activity_s *since);
+void perf_stall_dump(void);
+#endif
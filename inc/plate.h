@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+#if !defined(_PLATE_H)
+#define _PLATE_H
+
+#include <stddef.h>
+
+/* Indexed plate in res/images, made from a PNG by tools/plate_index.c */
+#define PLATE_SUFFIX ".gip"
+
+#define PLATE_MAGIC 0x50494547 /* "GEIP" */
+#define PLATE_VERSION 1
+
+#define PLATE_COLOURS_MAX 256
+/* Palettes of one plate, variant 0 is the drawn one */
+#define PLATE_VARIANTS_MAX 16
+
+/*
+ * File layout, in the byte order of the device:
+ * header, variants * colours palette entries of ARGB premultiplied like evas image data,
+ * then runs of one palette index from left to right and top to bottom. A run never crosses a row.
+ */
+typedef struct {
+	unsigned int magic;
+	unsigned short version;
+	unsigned short width;
+	unsigned short height;
+	unsigned short colours;
+	unsigned short variants;
+	unsigned short reserved;
+	unsigned int runs;
+} plate_header_s;
+
+/* Run of length + 1 pixels */
+typedef struct {
+	unsigned char length;
+	unsigned char index;
+} plate_run_s;
+
+/* Mapped plate file, checked once when it is opened */
+typedef struct {
+	void *map;
+	size_t size;
+	const plate_header_s *header;
+	const unsigned int *palettes;
+	const plate_run_s *runs;
+} plate_s;
+
+int plate_path_is_indexed(const char *path);
+int plate_open(plate_s *plate, const char *path);
+void plate_close(plate_s *plate);
+int plate_expand(const plate_s *plate, int variant, unsigned int *dst, int stride);
+#endif
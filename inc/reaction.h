@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+#if !defined(_REACTION_H)
+#define _REACTION_H
+
+/* Reaction time samples file in the data directory */
+#define REACTION_FILE "reaction.csv"
+
+/* Must be power of 2 */
+#define REACTION_RING_SIZE 256
+
+typedef struct {
+	unsigned int reaction_us;
+	unsigned char level;
+	unsigned char answer;
+	signed char tapped;
+} reaction_sample_s;
+
+int reaction_start(const char *path);
+void reaction_stop(void);
+void reaction_push(const reaction_sample_s *sample);
+unsigned int reaction_dropped_get(void);
+#endif
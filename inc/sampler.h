@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+#if !defined(_SAMPLER_H)
+#define _SAMPLER_H
+
+/* Plate difficulty is from 0 to this, one bucket per step. See tools/plate_calib.c */
+#define SAMPLER_DIFFICULTY_MAX 100
+
+/* Buckets on each side of the target which can be picked, weighted by distance */
+#define SAMPLER_WINDOW 8
+
+/* Recently shown plates are not picked again. Must be power of 2 */
+#define SAMPLER_RECENT 8
+
+/* Skill is on the difficulty scale, a new player starts on the easiest plates */
+#define SAMPLER_SKILL_INIT 10.0
+/* Skill step of a single answer and the spread of the expected success rate */
+#define SAMPLER_SKILL_K 6.0
+#define SAMPLER_SKILL_SCALE 8.0
+/* Plates are picked this far below the skill, about 70% of them are answered right */
+#define SAMPLER_TARGET_MARGIN 7.0
+
+int sampler_init(const unsigned char *difficulty, int count, unsigned int seed);
+void sampler_fini(void);
+int sampler_pick(double skill);
+void sampler_shown(int plate);
+double sampler_skill_update(double skill, int difficulty, int right);
+void sampler_answer(int plate, int right);
+double sampler_skill_get(void);
+#endif
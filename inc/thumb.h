@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+#if !defined(_THUMB_H)
+#define _THUMB_H
+
+/* Thumbnails of the level select, square ARGB premultiplied like evas image data */
+#define THUMB_SIZE 96
+
+/* Cache files in the data directory, one per plate named by the hash of the plate file */
+#define THUMB_DIR "thumbs/"
+#define THUMB_SUFFIX ".argb"
+#define THUMB_MAGIC 0x48544547
+#define THUMB_VERSION 1
+
+typedef struct {
+	unsigned int magic;
+	unsigned short version;
+	unsigned short size;
+	unsigned long long hash;
+} thumb_header_s;
+
+unsigned long long thumb_file_hash(const char *path);
+void thumb_cache_path(const char *dir, unsigned long long hash, char *path, int len);
+int thumb_cache_load(const char *path, unsigned long long hash, unsigned int *pixels);
+int thumb_cache_save(const char *path, unsigned long long hash, const unsigned int *pixels);
+void thumb_scale(const unsigned int *src, int w, int h, int stride, unsigned int *dst);
+#endif
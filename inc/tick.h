@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+#if !defined(_TICK_H)
+#define _TICK_H
+
+/* Slots of the timer wheel, one frame each. Must be power of 2 */
+#define TICK_WHEEL_SIZE 64
+/* Animator stops when the next deadline is further away, a single timer wakes it */
+#define TICK_PARK_FRAMES 8
+
+typedef void (*tick_cb)(void *data);
+
+/* Timer owned by the caller, the scheduler only links it into the wheel */
+typedef struct tick_timer {
+	struct tick_timer *next;
+	struct tick_timer **pprev;
+	double deadline;
+	long long tick;
+	tick_cb cb;
+	void *data;
+} tick_timer_s;
+
+void tick_timer_add(tick_timer_s *timer, double delay, tick_cb cb, void *data);
+void tick_timer_del(tick_timer_s *timer);
+Eina_Bool tick_timer_pending(const tick_timer_s *timer);
+double tick_timer_remaining_get(const tick_timer_s *timer);
+void tick_frame_end_cb_set(tick_cb cb, void *data);
+int tick_wakeup_count_get(void);
+void tick_shutdown(void);
+#endif
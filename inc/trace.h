@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+#if !defined(_TRACE_H)
+#define _TRACE_H
+
+#include <stddef.h>
+
+/*
+ * Touch trace file:
+ *   "GETR" magic, 1 byte version
+ *   per event: 1 byte type, varint time delta in ms,
+ *   zigzag varint x delta, zigzag varint y delta
+ */
+#define TRACE_MAGIC "GETR"
+#define TRACE_VERSION 1
+#define TRACE_HEADER_SIZE 5
+#define TRACE_EVENT_SIZE_MAX 16
+
+/* Default trace file in the data directory */
+#define TRACE_FILE "touch.trace"
+
+/* Touch event types */
+#define TRACE_EVENT_DOWN 0
+#define TRACE_EVENT_MOVE 1
+#define TRACE_EVENT_UP 2
+
+typedef struct {
+	int type;
+	int x;
+	int y;
+	unsigned int timestamp;
+} trace_event_s;
+
+typedef struct {
+	unsigned char *buf;
+	size_t len;
+	size_t pos;
+	trace_event_s last;
+} trace_reader_s;
+
+int trace_recorder_start(const char *path);
+int trace_recorder_is_running(void);
+void trace_recorder_add(int type, int x, int y, unsigned int timestamp);
+void trace_recorder_flush(void);
+void trace_recorder_stop(void);
+
+int trace_event_encode(unsigned char *out, const trace_event_s *ev, const trace_event_s *prev);
+int trace_reader_open(trace_reader_s *reader, const char *path);
+int trace_reader_next(trace_reader_s *reader, trace_event_s *ev);
+void trace_reader_rewind(trace_reader_s *reader);
+void trace_reader_close(trace_reader_s *reader);
+#endif
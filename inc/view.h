@@ -17,20 +17,11 @@
 #if !defined(_VIEW_H)
 #define _VIEW_H
 
+#include "catalog.h"
+
 #define EDJ_FILE "edje/main.edj"
 #define GRP_MAIN "main"
 
-#define RADIUS_MIN 82
-#define CENTER_REF_X 180
-#define CENTER_REF_Y 180
-
-/* Slope value for circular touch layer */
-#define SLOPE_36_DEGREE 0.7265
-#define SLOPE_72_DEGREE 3.0776
-#define SLOPE_108_DEGREE -3.0776
-#define SLOPE_144_DEGREE -0.7265
-#define SLOPE_180_DEGREE 0
-
 #define DAIL_INPUT_MAX 128
 
 /* Text Style for Dial Entry */
@@ -48,6 +39,50 @@
 
 #define LONGPRESS_TIME 0.5f
 
+/* Crossfade from the plate of the previous level, seconds. 0 for a hard cut */
+#define VIEW_TRANSITION_TIME 0.2
+
+/* Next plate is decoded once the crossfade is over, seconds */
+#define VIEW_PREFETCH_DELAY VIEW_TRANSITION_TIME
+
+/* Plate without input for this long goes to idle mode, seconds */
+#define IDLE_TIME 5.0
+
+/* Time to answer one plate in time attack, seconds */
+#define TIME_ATTACK_PLATE_TIME 5.0
+
+/* Offscreen canvas used to prewarm the font cache with the digits and every status string */
+#define PREWARM_CANVAS_W 360
+#define PREWARM_CANVAS_H 60
+#define PREWARM_DIGITS "0123456789"
+#define PREWARM_GLYPHS_MAX 1024
+
+/* Plates of level_data, level 0 is the greeting */
+#define VIEW_PLATE_MAX 100
+
+/* Data key of the evas image an indexed plate is expanded into, see inc/plate.h */
+#define VIEW_PLATE_INDEXED_KEY "view.plate.indexed"
+
+/* Level select opened by a tap in the centre of the greeting, square cells with a thumbnail of THUMB_SIZE */
+#define VIEW_SELECT_CELL_SIZE 120
+
+/* Formatted status text, on the stack */
+#define VIEW_STATUS_MAX 128
+
+/* Commands of the app_control automation API */
+typedef enum {
+	VIEW_AUTOMATION_LEVEL = 0,
+	VIEW_AUTOMATION_TAP,
+	VIEW_AUTOMATION_TAP_SECTOR,
+	VIEW_AUTOMATION_BENCH_TRANSITIONS,
+	VIEW_AUTOMATION_CACHE_RESET,
+	VIEW_AUTOMATION_STATS
+} view_automation_e;
+
+/* Must be power of 2 */
+#define VIEW_AUTOMATION_QUEUE_SIZE 16
+#define VIEW_BENCH_SAMPLES_MAX 4000
+
 void view_create(void);
 Evas_Object *view_create_win(const char *pkg_name);
 Evas_Object *view_create_conformant_without_indicator(Evas_Object *win);
@@ -67,4 +102,22 @@ void view_dialer_create(const char *file_path);
 int view_dialer_set_entry_text(int operation, const char *text);
 void view_dialer_set_entry(const char *part_name);
 Evas_Object *view_dialer_get_layout_object(void);
+void view_dialer_set_plate(const char *image_path);
+void view_dialer_release_resources(void);
+void view_dialer_restore_resources(void);
+void view_dialer_prefetch_next(void);
+void view_pause(void);
+void view_resume(void);
+void view_low_memory(void);
+void view_prewarm_start(void);
+void view_prewarm_cancel(void);
+int view_dialer_replay_trace(const char *path, Eina_Bool max_speed);
+void view_dialer_stop_replay(void);
+Eina_Bool view_dialer_replay_running(void);
+void view_dialer_set_level(int level);
+void view_dialer_set_best_score(int best_score);
+void view_dialer_set_status(catalog_str_e id, int a, int b);
+void view_dialer_refresh_status(void);
+void view_stats_dump(void);
+int view_automation_queue(view_automation_e command, int a, int b);
 #endif
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Status strings come from a compiled catalog mapped read-only, see tools/catalog_compile.c.
+ * Loading builds a table of text pointers into the mapping and swaps the active table atomically,
+ * readers only load one pointer. The table replaced is released on the next swap.
+ * Formatting copies text and numbers into the caller's buffer, nothing is allocated.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "catalog.h"
+
+typedef struct {
+	const char *text[CATALOG_STR_COUNT];
+	void *map;
+	size_t size;
+} catalog_s;
+
+static catalog_s s_builtin = {
+	.text = {
+#define CATALOG_TEXT(id, key, text) text,
+		CATALOG_STRINGS(CATALOG_TEXT)
+#undef CATALOG_TEXT
+	},
+	.map = NULL,
+	.size = 0,
+};
+
+static struct catalog_info {
+	catalog_s *active;
+	/* Replaced table, a reader of the main loop may still hold its text */
+	catalog_s *retired;
+} s_info = {
+	.active = &s_builtin,
+	.retired = NULL,
+};
+
+/*
+ * @brief Unmap and free the table, the built-in table stays
+ * @param[in] catalog Table to be freed
+ */
+static void _catalog_free(catalog_s *catalog)
+{
+	if (catalog == NULL || catalog == &s_builtin)
+		return;
+
+	munmap(catalog->map, catalog->size);
+	free(catalog);
+}
+
+/*
+ * @brief Make the table active and release the one replaced before
+ * @param[in] catalog Table to be active
+ */
+static void _catalog_swap(catalog_s *catalog)
+{
+	catalog_s *old = __atomic_exchange_n(&s_info.active, catalog, __ATOMIC_ACQ_REL);
+
+	_catalog_free(s_info.retired);
+	s_info.retired = old;
+}
+
+/*
+ * @brief Map a compiled catalog and make it active
+ * Strings missing from an older catalog fall back to the built-in text
+ * @param[in] path Path of the compiled catalog
+ */
+int catalog_load(const char *path)
+{
+	const catalog_header_s *header = NULL;
+	const catalog_entry_s *entry = NULL;
+	catalog_s *catalog = NULL;
+	struct stat st;
+	void *map = NULL;
+	int fd;
+	int i;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return -1;
+
+	if (fstat(fd, &st) || st.st_size < (off_t)sizeof(catalog_header_s)) {
+		close(fd);
+		return -1;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return -1;
+
+	header = map;
+	entry = (const catalog_entry_s *)(header + 1);
+	if (header->magic != CATALOG_MAGIC || header->version != CATALOG_VERSION
+			|| sizeof(*header) + header->count * sizeof(*entry) > (size_t)st.st_size) {
+		munmap(map, st.st_size);
+		return -1;
+	}
+
+	catalog = malloc(sizeof(*catalog));
+	if (catalog == NULL) {
+		munmap(map, st.st_size);
+		return -1;
+	}
+
+	catalog->map = map;
+	catalog->size = st.st_size;
+	for (i = 0; i < CATALOG_STR_COUNT; i++) {
+		catalog->text[i] = s_builtin.text[i];
+		if (i >= header->count)
+			continue;
+
+		/* Text must be inside the file and terminated */
+		if ((size_t)entry[i].offset + entry[i].length >= (size_t)st.st_size
+				|| ((const char *)map)[entry[i].offset + entry[i].length] != '\0') {
+			_catalog_free(catalog);
+			return -1;
+		}
+
+		catalog->text[i] = (const char *)map + entry[i].offset;
+	}
+
+	_catalog_swap(catalog);
+
+	return 0;
+}
+
+/*
+ * @brief Go back to the built-in English text
+ */
+void catalog_reset(void)
+{
+	if (__atomic_load_n(&s_info.active, __ATOMIC_ACQUIRE) != &s_builtin)
+		_catalog_swap(&s_builtin);
+}
+
+/*
+ * @brief Release every catalog, e.g. on terminate
+ */
+void catalog_shutdown(void)
+{
+	catalog_reset();
+	_catalog_free(s_info.retired);
+	s_info.retired = NULL;
+}
+
+/*
+ * @brief Get the compiled text of the string, numeric slots are CATALOG_SLOT and the argument number
+ * @param[in] id Id of the string
+ */
+const char *catalog_get(catalog_str_e id)
+{
+	if (id < 0 || id >= CATALOG_STR_COUNT)
+		return "";
+
+	return __atomic_load_n(&s_info.active, __ATOMIC_ACQUIRE)->text[id];
+}
+
+/*
+ * @brief Drop an incomplete UTF-8 sequence from the end of the text
+ * @param[in] buf Text
+ * @param[in] used Bytes of the text
+ * @return Bytes of the text without the incomplete sequence
+ */
+static int _catalog_utf8_trim(const char *buf, int used)
+{
+	int lead = used;
+	int need;
+
+	while (lead > 0 && (buf[lead - 1] & 0xc0) == 0x80)
+		lead--;
+	if (lead == 0)
+		return used;
+	lead--;
+
+	/* Length of the sequence from its lead byte */
+	if ((buf[lead] & 0xe0) == 0xc0)
+		need = 2;
+	else if ((buf[lead] & 0xf0) == 0xe0)
+		need = 3;
+	else if ((buf[lead] & 0xf8) == 0xf0)
+		need = 4;
+	else
+		return used;
+
+	return used - lead < need ? lead : used;
+}
+
+/*
+ * @brief Format the string into the buffer with the numbers in its slots
+ * Text is cut at the end of the buffer, which is always terminated
+ * @param[out] buf Buffer for the text
+ * @param[in] len Size of the buffer
+ * @param[in] id Id of the string
+ * @param[in] a Number of slot 0
+ * @param[in] b Number of slot 1
+ * Returns length of the text
+ */
+int catalog_format(char *buf, int len, catalog_str_e id, int a, int b)
+{
+	const char *text = catalog_get(id);
+	int args[CATALOG_ARGS_MAX] = { a, b };
+	char digits[12];
+	unsigned int value;
+	int arg;
+	int used = 0;
+	int n;
+
+	if (len < 1)
+		return 0;
+
+	for (; *text && used < len - 1; text++) {
+		if (*text != CATALOG_SLOT) {
+			buf[used++] = *text;
+			continue;
+		}
+
+		n = text[1] - '0';
+		if (n < 0 || n >= CATALOG_ARGS_MAX)
+			break;
+		arg = args[n];
+		text++;
+
+		/* Digits are made backwards, the sign goes first */
+		value = arg < 0 ? 0u - (unsigned int)arg : (unsigned int)arg;
+		n = 0;
+		do {
+			digits[n++] = (char)('0' + value % 10);
+			value /= 10;
+		} while (value);
+		if (arg < 0)
+			digits[n++] = '-';
+
+		while (n > 0 && used < len - 1)
+			buf[used++] = digits[--n];
+	}
+
+	/* Never leave half of a UTF-8 sequence at a cut, a complete last character stays */
+	if (*text && used > 0 && (buf[used - 1] & 0x80))
+		used = _catalog_utf8_trim(buf, used);
+
+	buf[used] = '\0';
+
+	return used;
+}
@@ -18,9 +18,109 @@
 #include <app.h>
 #include <efl_extension.h>
 #include <dlog.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <math.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include "dialer.h"
 #include "data.h"
 
+/* One progress record, the crc covers everything before it */
+struct data_record {
+	unsigned int seq;
+	unsigned short level;
+	unsigned short best_score;
+	unsigned int time;
+	unsigned int crc;
+};
+
+/* One completed run, the crc covers everything before it */
+struct data_run {
+	unsigned int time;
+	unsigned short score;
+	unsigned short level_count;
+	unsigned short level_ms[DATA_STATS_LEVEL_MAX + 1];
+	unsigned int crc;
+};
+
+#define DATA_STATS_MAGIC 0x54534547
+#define DATA_STATS_VERSION 1
+
+/*
+ * Leaderboard store, fixed size so queries never depend on the number of runs.
+ * Scores are bounded, a counting histogram keeps them ordered.
+ */
+struct data_stats {
+	unsigned int magic;
+	unsigned int version;
+	unsigned int runs;
+	unsigned int scores[DATA_STATS_SCORE_MAX + 1];
+	unsigned int level_samples[DATA_STATS_LEVEL_MAX + 1];
+	unsigned int level_times[DATA_STATS_LEVEL_MAX + 1][DATA_STATS_TIME_BUCKETS];
+};
+
+static struct data_info {
+	/* Resource path is asked once, tap path builds image paths without allocation */
+	char res_path[PATH_MAX];
+
+	char dir_path[PATH_MAX];
+	char log_path[PATH_MAX];
+	char tmp_path[PATH_MAX];
+	int fd;
+	unsigned int records;
+	/* Compaction is tried once the log holds this many records */
+	unsigned int compact_at;
+	struct data_record last;
+
+	/* Main loop hands the newest state to the writer thread, older unsaved states are dropped */
+	pthread_t writer;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int running;
+	int pending;
+	struct data_record next;
+	/* Completed runs waiting for the writer, every one of them is kept */
+	struct data_run runs[DATA_RUNS_QUEUE_SIZE];
+	unsigned int run_head;
+	unsigned int run_tail;
+
+	struct data_stats *stats;
+	int runs_fd;
+} s_info = {
+	.res_path = { 0, },
+
+	.dir_path = { 0, },
+	.log_path = { 0, },
+	.tmp_path = { 0, },
+	.fd = -1,
+	.records = 0,
+	.compact_at = DATA_PROGRESS_COMPACT_RECORDS,
+	.last = { 0, },
+
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER,
+	.running = 0,
+	.pending = 0,
+	.next = { 0, },
+	.runs = { { 0, }, },
+	.run_head = 0,
+	.run_tail = 0,
+
+	.stats = NULL,
+	.runs_fd = -1,
+};
+
+static void _data_progress_recover(void);
+static void *_data_progress_writer(void *data);
+static void _data_stats_open(void);
+static void _data_runs_open(void);
+static void _data_runs_append(const struct data_run *run);
+static const char *_data_res_path_get(void);
+
 /*
  * @brief Initialization function for data module
  */
@@ -30,6 +130,24 @@ void data_initialize(void)
 	 * If you need to initialize managing data,
 	 * please use this function.
 	 */
+	_data_res_path_get();
+
+	data_get_data_path("", s_info.dir_path, (int)sizeof(s_info.dir_path));
+	data_get_data_path(DATA_PROGRESS_FILE, s_info.log_path, (int)sizeof(s_info.log_path));
+	data_get_data_path(DATA_PROGRESS_TMP_FILE, s_info.tmp_path, (int)sizeof(s_info.tmp_path));
+
+	_data_stats_open();
+	_data_runs_open();
+
+	_data_progress_recover();
+	if (s_info.fd < 0)
+		return;
+
+	s_info.running = 1;
+	if (pthread_create(&s_info.writer, NULL, _data_progress_writer, NULL)) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to start progress writer.");
+		s_info.running = 0;
+	}
 }
 
 /*
@@ -41,6 +159,29 @@ void data_finalize(void)
 	 * If you need to finalize managing data,
 	 * please use this function.
 	 */
+	if (s_info.running) {
+		pthread_mutex_lock(&s_info.lock);
+		s_info.running = 0;
+		pthread_cond_signal(&s_info.cond);
+		pthread_mutex_unlock(&s_info.lock);
+
+		pthread_join(s_info.writer, NULL);
+	}
+
+	if (s_info.fd >= 0) {
+		close(s_info.fd);
+		s_info.fd = -1;
+	}
+
+	if (s_info.runs_fd >= 0) {
+		close(s_info.runs_fd);
+		s_info.runs_fd = -1;
+	}
+
+	if (s_info.stats) {
+		munmap(s_info.stats, sizeof(struct data_stats));
+		s_info.stats = NULL;
+	}
 }
 
 /*
@@ -58,6 +199,21 @@ void data_get_full_path(const char *file_path, char *full_path, int path_max)
 	}
 }
 
+/*
+ * @brief Get full path of file in the application data directory
+ * @param[in] file_name Name of target file
+ * @param[out] full_path Full file path concatenated with data path
+ * @param[in] path_max Max length of full file path
+ */
+void data_get_data_path(const char *file_name, char *full_path, int path_max)
+{
+	char *data_path = app_get_data_path();
+	if (data_path) {
+		snprintf(full_path, path_max, "%s%s", data_path, file_name);
+		free(data_path);
+	}
+}
+
 /*
  * @brief Get path of image file for part
  * @param[in] part_name Part name of the target image path
@@ -72,19 +228,8 @@ char *data_get_image_path(const char *part_name)
 	char *res_path = app_get_resource_path();
 
 	if (res_path) {
-		if (!strcmp("sw.button.bg", part_name))
-			snprintf(full_path, sizeof(full_path) - 1, "%s%s", res_path, "images/dialer_button_bg.png");
-		else if (!strcmp("sw.button.call", part_name))
-			snprintf(full_path, sizeof(full_path) - 1, "%s%s", res_path, "images/dialer_btn_call_icon.png");
-		else if (!strcmp("sw.button.call.ef", part_name))
-			snprintf(full_path, sizeof(full_path) - 1, "%s%s", res_path, "images/dialer_btn_call_icon_ef.png");
-		else if (!strcmp("sw.button.delete", part_name))
-			snprintf(full_path, sizeof(full_path) - 1, "%s%s", res_path, "images/dialer_btn_back.png");
-		else if (!strcmp("sw.image.effect", part_name))
-			snprintf(full_path, sizeof(full_path) - 1, "%s%s", res_path, "images/dialer_fadeout.#.png");
-		else {
-			snprintf(full_path, sizeof(full_path) - 1, "%s%s", res_path, "images/dialer_button_bg.png");
-		}
+		/* Greeting background of "sw.button.bg" is the only image set by part name */
+		snprintf(full_path, sizeof(full_path) - 1, "%s%s", res_path, "images/dialer_button_bg.png");
 
 		ret = strdup(full_path);
 		free(res_path);
@@ -93,20 +238,716 @@ char *data_get_image_path(const char *part_name)
 	return ret;
 }
 
-char *data_get_level_full_image_path(const char *path)
+/*
+ * @brief Get resource path, cached after the first call
+ */
+static const char *_data_res_path_get(void)
 {
-	/*
-	 * You can use this function to retrieve data.
-	 */
-	char *ret = NULL;
-	char full_path[PATH_MAX] = { 0, };
-	char *res_path = app_get_resource_path();
+	char *res_path = NULL;
 
-	if (res_path) {
-		snprintf(full_path, sizeof(full_path) - 1, "%s%s%s", res_path, "images/", path);
-		ret = strdup(full_path);
-		free(res_path);
+	if (s_info.res_path[0] == '\0') {
+		res_path = app_get_resource_path();
+		if (res_path) {
+			snprintf(s_info.res_path, sizeof(s_info.res_path), "%s", res_path);
+			free(res_path);
+		}
 	}
 
-	return ret;
+	return s_info.res_path;
+}
+
+/*
+ * @brief Get full path of level image without any allocation
+ * @param[in] file_name File name of the level image
+ * @param[out] full_path Full file path of the level image
+ * @param[in] path_max Max length of full file path
+ */
+void data_get_level_image_path(const char *file_name, char *full_path, int path_max)
+{
+	snprintf(full_path, path_max, "%s%s%s", _data_res_path_get(), "images/", file_name);
+}
+
+/*
+ * @brief Get resident set size of this process
+ * Returns RSS in kB, -1 if it cannot be read
+ */
+int data_get_rss_kb(void)
+{
+	char line[128] = { 0, };
+	int rss = -1;
+	FILE *fp = fopen("/proc/self/status", "r");
+
+	if (fp == NULL)
+		return -1;
+
+	while (fgets(line, sizeof(line), fp)) {
+		if (!strncmp(line, "VmRSS:", 6)) {
+			rss = atoi(line + 6);
+			break;
+		}
+	}
+
+	fclose(fp);
+
+	return rss;
+}
+
+/*
+ * @brief Calculate CRC-32 of the buffer
+ * @param[in] buf Buffer
+ * @param[in] len Length of the buffer
+ */
+static unsigned int _data_crc32(const void *buf, size_t len)
+{
+	const unsigned char *p = buf;
+	unsigned int crc = 0xffffffff;
+	int i;
+
+	while (len--) {
+		crc ^= *p++;
+		for (i = 0; i < 8; i++)
+			crc = (crc >> 1) ^ (0xedb88320 & (0u - (crc & 1)));
+	}
+
+	return ~crc;
+}
+
+/*
+ * @brief Check whether the record is complete and not corrupted
+ * @param[in] record Record to be checked
+ */
+static int _data_record_valid(const struct data_record *record)
+{
+	return record->crc == _data_crc32(record, offsetof(struct data_record, crc));
+}
+
+/*
+ * @brief Stop using the progress log, it is left on the disk as it is
+ * @param[in] reason What went wrong
+ */
+static void _data_progress_keep(const char *reason)
+{
+	dlog_print(DLOG_ERROR, LOG_TAG, "%s %s, progress is not saved", reason, s_info.log_path);
+
+	if (s_info.fd >= 0) {
+		close(s_info.fd);
+		s_info.fd = -1;
+	}
+}
+
+/*
+ * @brief Find the last valid record scanning back from the end, drop anything after it
+ * The log is kept untouched and not written to if it cannot be read or holds no valid record
+ */
+static void _data_progress_recover(void)
+{
+	struct data_record tail[DATA_PROGRESS_TAIL_RECORDS];
+	struct stat st;
+	off_t count = 0;
+	off_t first = 0;
+	off_t valid_end = -1;
+	int n;
+
+	s_info.fd = open(s_info.log_path, O_RDWR | O_APPEND | O_CREAT, 0600);
+	if (s_info.fd < 0 || fstat(s_info.fd, &st)) {
+		_data_progress_keep("failed to open");
+		return;
+	}
+
+	/* A torn last record is cut off by the division */
+	count = st.st_size / (off_t)sizeof(struct data_record);
+
+	/* Usually the last record is good, older ones are read only after a corrupted tail */
+	while (count > 0 && valid_end < 0) {
+		first = count > DATA_PROGRESS_TAIL_RECORDS ? count - DATA_PROGRESS_TAIL_RECORDS : 0;
+		n = (int)(count - first);
+
+		if (pread(s_info.fd, tail, n * sizeof(struct data_record), first * sizeof(struct data_record)) != (ssize_t)(n * sizeof(struct data_record))) {
+			_data_progress_keep("failed to read");
+			return;
+		}
+
+		while (n-- > 0) {
+			if (_data_record_valid(&tail[n])) {
+				s_info.last = tail[n];
+				valid_end = (first + n + 1) * (off_t)sizeof(struct data_record);
+				break;
+			}
+		}
+		count = first;
+	}
+
+	if (valid_end < 0) {
+		/* Less than one record is only a torn first write */
+		if (st.st_size >= (off_t)sizeof(struct data_record)) {
+			_data_progress_keep("no valid record in");
+			return;
+		}
+		valid_end = 0;
+	}
+
+	if (valid_end != st.st_size && ftruncate(s_info.fd, valid_end))
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to truncate %s", s_info.log_path);
+
+	s_info.records = (unsigned int)(valid_end / (off_t)sizeof(struct data_record));
+}
+
+/*
+ * @brief Sync the data directory, a rename in it survives a power loss only after this
+ */
+static void _data_dir_sync(void)
+{
+	int fd = open(s_info.dir_path, O_RDONLY | O_DIRECTORY);
+
+	if (fd < 0 || fsync(fd))
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to sync %s", s_info.dir_path);
+
+	if (fd >= 0)
+		close(fd);
+}
+
+/*
+ * @brief Replace the log by a new one holding only the given record
+ * @param[in] record The latest record
+ * Returns 0 if the record is in the new log, -1 if the log is left as it was
+ */
+static int _data_progress_compact(const struct data_record *record)
+{
+	int fd = open(s_info.tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+
+	if (fd < 0)
+		return -1;
+
+	if (write(fd, record, sizeof(*record)) != (ssize_t)sizeof(*record) || fsync(fd)) {
+		close(fd);
+		unlink(s_info.tmp_path);
+		return -1;
+	}
+	close(fd);
+
+	/* rename() is atomic, a crash leaves either the old or the new log */
+	if (rename(s_info.tmp_path, s_info.log_path)) {
+		unlink(s_info.tmp_path);
+		return -1;
+	}
+	_data_dir_sync();
+
+	/* Descriptor of the replaced log is useless now, if the new one fails to open the next append retries */
+	close(s_info.fd);
+	s_info.fd = open(s_info.log_path, O_RDWR | O_APPEND);
+	s_info.records = 1;
+	s_info.compact_at = DATA_PROGRESS_COMPACT_RECORDS;
+
+	return 0;
+}
+
+/*
+ * @brief Append the record to the log, compacting it when it is long
+ * A failed compaction never loses the record, it is appended and compaction is retried later
+ * @param[in] record Record to be appended
+ */
+static void _data_progress_append(const struct data_record *record)
+{
+	if (s_info.fd < 0) {
+		s_info.fd = open(s_info.log_path, O_RDWR | O_APPEND | O_CREAT, 0600);
+		if (s_info.fd < 0) {
+			dlog_print(DLOG_ERROR, LOG_TAG, "failed to open %s, progress of level %d is not saved", s_info.log_path, record->level);
+			return;
+		}
+	}
+
+	if (s_info.records >= s_info.compact_at) {
+		if (!_data_progress_compact(record))
+			return;
+
+		s_info.compact_at = s_info.records + DATA_PROGRESS_COMPACT_RETRY_RECORDS;
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to compact %s, retry after %d records", s_info.log_path, DATA_PROGRESS_COMPACT_RETRY_RECORDS);
+	}
+
+	if (write(s_info.fd, record, sizeof(*record)) == (ssize_t)sizeof(*record))
+		s_info.records++;
+	else
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to write %s, progress of level %d is not saved", s_info.log_path, record->level);
+}
+
+/*
+ * @brief Writer thread, appends the newest state and the completed runs, syncs at most once per interval
+ * @param[in] data The data to be passed to the thread
+ */
+static void *_data_progress_writer(void *data)
+{
+	struct data_record record;
+	struct data_run runs[DATA_RUNS_QUEUE_SIZE];
+	struct timespec deadline;
+	int has_record;
+	int run_count;
+	int i;
+
+	pthread_mutex_lock(&s_info.lock);
+	while (1) {
+		while (s_info.running && !s_info.pending && s_info.run_head == s_info.run_tail)
+			pthread_cond_wait(&s_info.cond, &s_info.lock);
+
+		if (!s_info.pending && s_info.run_head == s_info.run_tail)
+			break;
+
+		has_record = s_info.pending;
+		record = s_info.next;
+		s_info.pending = 0;
+		for (run_count = 0; s_info.run_tail != s_info.run_head; run_count++)
+			runs[run_count] = s_info.runs[s_info.run_tail++ % DATA_RUNS_QUEUE_SIZE];
+		pthread_mutex_unlock(&s_info.lock);
+
+		if (has_record)
+			_data_progress_append(&record);
+		for (i = 0; i < run_count; i++)
+			_data_runs_append(&runs[i]);
+
+		/* No sync on exit, the page cache survives a killed process */
+		pthread_mutex_lock(&s_info.lock);
+		if (!s_info.running)
+			continue;
+		pthread_mutex_unlock(&s_info.lock);
+
+		if (has_record && s_info.fd >= 0)
+			fdatasync(s_info.fd);
+		if (run_count && s_info.runs_fd >= 0)
+			fdatasync(s_info.runs_fd);
+
+		/* Let saves of the next interval pile up into one record and one sync, unless runs fill up the queue */
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += DATA_PROGRESS_SYNC_INTERVAL;
+
+		pthread_mutex_lock(&s_info.lock);
+		while (s_info.running && s_info.run_head - s_info.run_tail < DATA_RUNS_QUEUE_SIZE / 2
+				&& pthread_cond_timedwait(&s_info.cond, &s_info.lock, &deadline) == 0)
+			;
+	}
+	pthread_mutex_unlock(&s_info.lock);
+
+	return NULL;
+}
+
+/*
+ * @brief Get progress recovered at initialization
+ * @param[out] level Level of the last saved game
+ * @param[out] best_score Best score so far
+ */
+void data_progress_get(int *level, int *best_score)
+{
+	if (level)
+		*level = s_info.last.level;
+	if (best_score)
+		*best_score = s_info.last.best_score;
+}
+
+/*
+ * @brief Save progress without blocking, the writer thread does the file I/O
+ * @param[in] level Current level
+ * @param[in] best_score Best score so far
+ */
+void data_progress_save(int level, int best_score)
+{
+	struct data_record record = { 0, };
+
+	if (!s_info.running)
+		return;
+
+	record.seq = ++s_info.last.seq;
+	record.level = (unsigned short)level;
+	record.best_score = (unsigned short)best_score;
+	record.time = (unsigned int)time(NULL);
+	record.crc = _data_crc32(&record, offsetof(struct data_record, crc));
+	s_info.last = record;
+
+	/* Lock is only held by the writer to copy one record */
+	pthread_mutex_lock(&s_info.lock);
+	s_info.next = record;
+	s_info.pending = 1;
+	pthread_cond_signal(&s_info.cond);
+	pthread_mutex_unlock(&s_info.lock);
+}
+
+/*
+ * @brief Map the leaderboard store, updates go to the page cache without any syscall
+ */
+static void _data_stats_open(void)
+{
+	char path[PATH_MAX] = { 0, };
+	struct stat st;
+	void *map = NULL;
+	int fd;
+
+	data_get_data_path(DATA_STATS_FILE, path, (int)sizeof(path));
+
+	fd = open(path, O_RDWR | O_CREAT, 0600);
+	if (fd < 0)
+		return;
+
+	if (fstat(fd, &st) || (st.st_size != sizeof(struct data_stats) && ftruncate(fd, sizeof(struct data_stats)))) {
+		close(fd);
+		return;
+	}
+
+	map = mmap(NULL, sizeof(struct data_stats), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to map %s", path);
+		return;
+	}
+
+	s_info.stats = map;
+	if (s_info.stats->magic != DATA_STATS_MAGIC || s_info.stats->version != DATA_STATS_VERSION) {
+		memset(s_info.stats, 0, sizeof(struct data_stats));
+		s_info.stats->magic = DATA_STATS_MAGIC;
+		s_info.stats->version = DATA_STATS_VERSION;
+	}
+}
+
+/*
+ * @brief Open the log of completed runs, a torn last record is cut off
+ */
+static void _data_runs_open(void)
+{
+	char path[PATH_MAX] = { 0, };
+	struct stat st;
+
+	data_get_data_path(DATA_RUNS_FILE, path, (int)sizeof(path));
+
+	s_info.runs_fd = open(path, O_RDWR | O_APPEND | O_CREAT, 0600);
+	if (s_info.runs_fd < 0 || fstat(s_info.runs_fd, &st)) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to open %s, runs are not logged", path);
+		if (s_info.runs_fd >= 0)
+			close(s_info.runs_fd);
+		s_info.runs_fd = -1;
+		return;
+	}
+
+	if (st.st_size % (off_t)sizeof(struct data_run) && ftruncate(s_info.runs_fd, st.st_size - st.st_size % (off_t)sizeof(struct data_run)))
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to truncate %s", path);
+}
+
+/*
+ * @brief Append a completed run to the log of runs, called by the writer thread
+ * @param[in] run Run to be appended
+ */
+static void _data_runs_append(const struct data_run *run)
+{
+	if (s_info.runs_fd < 0)
+		return;
+
+	if (write(s_info.runs_fd, run, sizeof(*run)) != (ssize_t)sizeof(*run))
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to log a run of score %d", run->score);
+}
+
+/*
+ * @brief Queue a completed run for the writer thread
+ * @param[in] score Score of the run, already clamped
+ * @param[in] level_times_ms Reaction time of each level, index is the level, 0 if not played
+ * @param[in] level_count Number of entries of level_times_ms
+ */
+static void _data_runs_queue(int score, const unsigned int *level_times_ms, int level_count)
+{
+	struct data_run *run = NULL;
+	int level;
+
+	if (!s_info.running || s_info.runs_fd < 0)
+		return;
+
+	pthread_mutex_lock(&s_info.lock);
+	if (s_info.run_head - s_info.run_tail >= DATA_RUNS_QUEUE_SIZE) {
+		pthread_mutex_unlock(&s_info.lock);
+		dlog_print(DLOG_ERROR, LOG_TAG, "run queue is full, a run of score %d is not logged", score);
+		return;
+	}
+
+	/* Copied in place into the queue, no allocation */
+	run = &s_info.runs[s_info.run_head % DATA_RUNS_QUEUE_SIZE];
+	memset(run, 0, sizeof(*run));
+	run->time = (unsigned int)time(NULL);
+	run->score = (unsigned short)score;
+	run->level_count = (unsigned short)(level_count > DATA_STATS_LEVEL_MAX + 1 ? DATA_STATS_LEVEL_MAX + 1 : level_count);
+	for (level = 1; level < run->level_count; level++)
+		run->level_ms[level] = (unsigned short)(level_times_ms[level] > 0xffff ? 0xffff : level_times_ms[level]);
+	run->crc = _data_crc32(run, offsetof(struct data_run, crc));
+
+	s_info.run_head++;
+	pthread_cond_signal(&s_info.cond);
+	pthread_mutex_unlock(&s_info.lock);
+}
+
+/*
+ * @brief Get number of runs in the log of runs
+ */
+int data_stats_run_count_get(void)
+{
+	struct stat st;
+
+	if (s_info.runs_fd < 0 || fstat(s_info.runs_fd, &st))
+		return 0;
+
+	return (int)(st.st_size / (off_t)sizeof(struct data_run));
+}
+
+/*
+ * @brief Read a completed run back from the log of runs
+ * @param[in] index Index of the run, 0 is the first run ever logged
+ * @param[out] score Score of the run
+ * @param[out] level_times_ms Reaction time of each level, index is the level, 0 if not played
+ * @param[in] level_count Number of entries of level_times_ms
+ * Returns number of entries of the run, -1 if it cannot be read or is corrupted
+ */
+int data_stats_run_get(int index, int *score, unsigned int *level_times_ms, int level_count)
+{
+	struct data_run run;
+	int level;
+
+	if (s_info.runs_fd < 0 || index < 0)
+		return -1;
+
+	if (pread(s_info.runs_fd, &run, sizeof(run), (off_t)index * (off_t)sizeof(run)) != (ssize_t)sizeof(run)
+			|| run.crc != _data_crc32(&run, offsetof(struct data_run, crc)))
+		return -1;
+
+	if (score)
+		*score = run.score;
+
+	for (level = 0; level < level_count; level++)
+		level_times_ms[level] = level < run.level_count ? run.level_ms[level] : 0;
+
+	return run.level_count;
+}
+
+/*
+ * @brief Get histogram bucket of the reaction time
+ * @param[in] ms Reaction time in ms
+ */
+static int _data_stats_time_bucket(unsigned int ms)
+{
+	int bucket;
+
+	if (ms <= DATA_STATS_TIME_BASE_MS)
+		return 0;
+
+	bucket = (int)(log2((double)ms / DATA_STATS_TIME_BASE_MS) * 4.0) + 1;
+	if (bucket >= DATA_STATS_TIME_BUCKETS)
+		bucket = DATA_STATS_TIME_BUCKETS - 1;
+
+	return bucket;
+}
+
+/*
+ * @brief Get lower bound in ms of the histogram bucket
+ * @param[in] bucket Histogram bucket
+ */
+static double _data_stats_bucket_ms(int bucket)
+{
+	if (bucket <= 0)
+		return 0.0;
+
+	return DATA_STATS_TIME_BASE_MS * exp2((bucket - 1) / 4.0);
+}
+
+/*
+ * @brief Add a finished run to the leaderboard
+ * @param[in] score Score of the run
+ * @param[in] level_times_ms Reaction time of each level, index is the level, 0 if not played
+ * @param[in] level_count Number of entries of level_times_ms
+ */
+void data_stats_add_run(int score, const unsigned int *level_times_ms, int level_count)
+{
+	int level;
+
+	if (score < 0)
+		score = 0;
+	else if (score > DATA_STATS_SCORE_MAX)
+		score = DATA_STATS_SCORE_MAX;
+
+	_data_runs_queue(score, level_times_ms, level_count);
+
+	if (s_info.stats == NULL)
+		return;
+
+	s_info.stats->runs++;
+	s_info.stats->scores[score]++;
+
+	for (level = 1; level < level_count && level <= DATA_STATS_LEVEL_MAX; level++) {
+		if (level_times_ms[level] == 0)
+			continue;
+
+		s_info.stats->level_samples[level]++;
+		s_info.stats->level_times[level][_data_stats_time_bucket(level_times_ms[level])]++;
+	}
+}
+
+/*
+ * @brief Get number of runs so far
+ */
+unsigned int data_stats_runs_get(void)
+{
+	return s_info.stats ? s_info.stats->runs : 0;
+}
+
+/*
+ * @brief Get best scores in descending order
+ * @param[out] scores Array to be filled
+ * @param[in] n Size of the array
+ * Returns number of scores filled
+ */
+int data_stats_top_scores_get(int *scores, int n)
+{
+	int score;
+	int filled = 0;
+	unsigned int i;
+
+	if (s_info.stats == NULL)
+		return 0;
+
+	for (score = DATA_STATS_SCORE_MAX; score >= 0 && filled < n; score--)
+		for (i = 0; i < s_info.stats->scores[score] && filled < n; i++)
+			scores[filled++] = score;
+
+	return filled;
+}
+
+/*
+ * @brief Get share of runs scoring below the score, in percent
+ * @param[in] score Score to be ranked
+ */
+double data_stats_score_percentile_get(int score)
+{
+	unsigned int below = 0;
+	int i;
+
+	if (s_info.stats == NULL || s_info.stats->runs == 0)
+		return 0.0;
+
+	if (score > DATA_STATS_SCORE_MAX + 1)
+		score = DATA_STATS_SCORE_MAX + 1;
+
+	for (i = 0; i < score; i++)
+		below += s_info.stats->scores[i];
+
+	return below * 100.0 / s_info.stats->runs;
+}
+
+/*
+ * @brief Get median reaction time of the level, interpolated inside the histogram bucket
+ * @param[in] level Level
+ * Returns median in ms, -1 if the level has no samples
+ */
+int data_stats_level_median_get(int level)
+{
+	const unsigned int *hist = NULL;
+	unsigned int half;
+	unsigned int seen = 0;
+	double low, high;
+	int bucket;
+
+	if (s_info.stats == NULL || level < 1 || level > DATA_STATS_LEVEL_MAX || s_info.stats->level_samples[level] == 0)
+		return -1;
+
+	hist = s_info.stats->level_times[level];
+	half = (s_info.stats->level_samples[level] + 1) / 2;
+
+	for (bucket = 0; bucket < DATA_STATS_TIME_BUCKETS; bucket++) {
+		if (seen + hist[bucket] >= half)
+			break;
+		seen += hist[bucket];
+	}
+
+	if (bucket >= DATA_STATS_TIME_BUCKETS)
+		bucket = DATA_STATS_TIME_BUCKETS - 1;
+
+	low = _data_stats_bucket_ms(bucket);
+	high = _data_stats_bucket_ms(bucket + 1);
+
+	return (int)(low + (high - low) * (half - seen) / hist[bucket]);
+}
+
+/*
+ * @brief Print leaderboard and reaction time histograms as JSON members, without braces
+ * @param[out] buf Buffer to be filled
+ * @param[in] len Size of the buffer
+ * @param[in] level_count Number of levels to report medians for
+ * Returns number of characters written, -1 and an empty buffer if they do not fit, never a cut member
+ */
+int data_stats_json_get(char *buf, int len, int level_count)
+{
+	unsigned int hist[DATA_STATS_TIME_BUCKETS] = { 0, };
+	int top[5] = { 0, };
+	int top_count;
+	int used;
+	int last = 0;
+	int level;
+	int bucket;
+	int i;
+
+	if (buf == NULL || len <= 0)
+		return 0;
+
+	used = snprintf(buf, len, "\"runs\":%u,\"top\":[", data_stats_runs_get());
+
+	top_count = data_stats_top_scores_get(top, (int)(sizeof(top) / sizeof(top[0])));
+	for (i = 0; i < top_count && used < len; i++)
+		used += snprintf(buf + used, len - used, "%s%d", i ? "," : "", top[i]);
+
+	if (used < len)
+		used += snprintf(buf + used, len - used, "],\"level_median_ms\":[");
+
+	if (level_count > DATA_STATS_LEVEL_MAX)
+		level_count = DATA_STATS_LEVEL_MAX;
+	for (level = 1; level <= level_count && used < len; level++)
+		used += snprintf(buf + used, len - used, "%s%d", level > 1 ? "," : "", data_stats_level_median_get(level));
+
+	/* All levels in one histogram, trailing empty buckets are left out */
+	if (s_info.stats) {
+		for (level = 1; level <= DATA_STATS_LEVEL_MAX; level++)
+			for (bucket = 0; bucket < DATA_STATS_TIME_BUCKETS; bucket++)
+				hist[bucket] += s_info.stats->level_times[level][bucket];
+	}
+	for (bucket = 0; bucket < DATA_STATS_TIME_BUCKETS; bucket++)
+		if (hist[bucket])
+			last = bucket + 1;
+
+	if (used < len)
+		used += snprintf(buf + used, len - used, "],\"time_base_ms\":%d,\"time_hist\":[", DATA_STATS_TIME_BASE_MS);
+	for (bucket = 0; bucket < last && used < len; bucket++)
+		used += snprintf(buf + used, len - used, "%s%u", bucket ? "," : "", hist[bucket]);
+
+	if (used < len)
+		used += snprintf(buf + used, len - used, "]");
+
+	if (used >= len) {
+		buf[0] = '\0';
+		return -1;
+	}
+
+	return used;
+}
+
+/*
+ * @brief Append one line to the stats dump file in the data directory
+ * @param[in] line Line without the newline
+ */
+int data_stats_dump_append(const char *line)
+{
+	char path[PATH_MAX] = { 0, };
+	FILE *fp = NULL;
+
+	if (line == NULL)
+		return -1;
+
+	data_get_data_path(DATA_STATS_DUMP_FILE, path, (int)sizeof(path));
+
+	fp = fopen(path, "a");
+	if (fp == NULL) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to open %s", path);
+		return -1;
+	}
+
+	fprintf(fp, "%s\n", line);
+	fclose(fp);
+
+	return 0;
 }
@@ -0,0 +1,452 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Dial hit test, on single touches for the view and on arrays of points for analytics.
+ * Only libc is used here, so host tools can classify traces too.
+ *
+ * The left half of the dial mirrors the right one. On the right half a point is past the boundary
+ * at angle b from the top if x * cos(b) > y * sin(b), and its sector is the number of boundaries
+ * it is past. There is no division, so the same test runs on SSE2 and on ARMv7 NEON, and the batch
+ * classifier gives the same sectors as dial_sector_get() for every point on screen.
+ */
+
+#include <math.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+#include "dial.h"
+
+#define DIAL_PI 3.14159265358979f
+
+/*
+ * Sine on [-pi / 2, pi / 2] as a constant expression, Taylor series to the 15th power, error below 1e-11.
+ * Boundaries of every layout are computed with it at compile time.
+ */
+#define DIAL_SIN_Q(a) ((a) * (1.0 - (a) * (a) / 6.0 * (1.0 - (a) * (a) / 20.0 * (1.0 - (a) * (a) / 42.0 \
+		* (1.0 - (a) * (a) / 72.0 * (1.0 - (a) * (a) / 110.0 * (1.0 - (a) * (a) / 156.0 * (1.0 - (a) * (a) / 210.0))))))))
+/* Boundary on an axis must be exactly on it, or points on the axis fall on either side */
+#define DIAL_ZERO(v) ((v) < 1e-9 && (v) > -1e-9 ? 0.0 : (v))
+/* Sine and cosine on [0, pi] */
+#define DIAL_SIN(a) DIAL_ZERO(DIAL_SIN_Q((a) <= M_PI / 2.0 ? (a) : M_PI - (a)))
+#define DIAL_COS(a) DIAL_ZERO(DIAL_SIN_Q(M_PI / 2.0 - (a)))
+
+/* Boundary k of a layout with n sectors is between sectors k and k + 1, clockwise from the top */
+#define DIAL_BOUND_ANGLE(k, n) ((2.0 * (k) + 1.0) * M_PI / (n))
+#define DIAL_BOUND(k, n) { \
+	(k) < (n) / 2 ? (float)DIAL_COS(DIAL_BOUND_ANGLE(k, n)) : 0.0f, \
+	(k) < (n) / 2 ? (float)DIAL_SIN(DIAL_BOUND_ANGLE(k, n)) : 0.0f }
+
+/* Cosine and sine of the boundaries on the right half, the only runtime data of a layout */
+#define DIAL_BOUND_TABLE(id, sectors, ring) \
+typedef char _dial_##id##_check[(sectors) >= 2 && (sectors) <= DIAL_LAYOUT_SECTORS_MAX && (ring) < CENTER_REF_X ? 1 : -1]; \
+static const float s_##id##_bound[DIAL_LAYOUT_SECTORS_MAX / 2][2] = { \
+	DIAL_BOUND(0, sectors), DIAL_BOUND(1, sectors), DIAL_BOUND(2, sectors), DIAL_BOUND(3, sectors), \
+	DIAL_BOUND(4, sectors), DIAL_BOUND(5, sectors), DIAL_BOUND(6, sectors), DIAL_BOUND(7, sectors), \
+};
+DIAL_LAYOUTS(DIAL_BOUND_TABLE)
+#undef DIAL_BOUND_TABLE
+
+/* Point of the right half is past boundary k, the term is dropped for layouts with fewer boundaries */
+#define DIAL_PAST(id, sectors, k, xa, y) \
+	((k) < (sectors) / 2 && (xa) * s_##id##_bound[k][0] > (y) * s_##id##_bound[k][1])
+
+/*
+ * Classifier of each layout, fully unrolled with constant boundaries.
+ * Takes the touch position on screen, returns the sector or -1 inside RADIUS_MIN.
+ */
+#define DIAL_CLASSIFIER(id, sectors, ring) \
+static int _dial_sector_get_##id(int evt_x, int evt_y) \
+{ \
+	int x = evt_x - CENTER_REF_X; \
+	int y = CENTER_REF_Y - evt_y; \
+	int r2 = x * x + y * y; \
+	float xa = (float)(x < 0 ? -x : x); \
+	float yf = (float)y; \
+	int sector; \
+\
+	if (r2 <= RADIUS_MIN * RADIUS_MIN) \
+		return -1; \
+\
+	sector = DIAL_PAST(id, sectors, 0, xa, yf) + DIAL_PAST(id, sectors, 1, xa, yf) \
+			+ DIAL_PAST(id, sectors, 2, xa, yf) + DIAL_PAST(id, sectors, 3, xa, yf) \
+			+ DIAL_PAST(id, sectors, 4, xa, yf) + DIAL_PAST(id, sectors, 5, xa, yf) \
+			+ DIAL_PAST(id, sectors, 6, xa, yf) + DIAL_PAST(id, sectors, 7, xa, yf); \
+	if (x < 0 && sector > 0) \
+		sector = (sectors) - sector; \
+	if ((ring) > 0 && r2 > (ring) * (ring)) \
+		sector += (sectors); \
+\
+	return sector; \
+}
+DIAL_LAYOUTS(DIAL_CLASSIFIER)
+#undef DIAL_CLASSIFIER
+
+static const struct dial_layout_info {
+	int (*sector_get)(int evt_x, int evt_y);
+	int sectors;
+	int ring;
+} s_layouts[DIAL_LAYOUT_COUNT] = {
+#define DIAL_LAYOUT_INFO(id, sectors, ring) { _dial_sector_get_##id, sectors, ring },
+	DIAL_LAYOUTS(DIAL_LAYOUT_INFO)
+#undef DIAL_LAYOUT_INFO
+};
+
+/*
+ * @brief Get the sector of a touch on a layout
+ * @param[in] layout Dial layout
+ * @param[in] x X of the touch on screen
+ * @param[in] y Y of the touch on screen
+ * Returns sector from 0 to dial_layout_targets_get() - 1, -1 inside RADIUS_MIN
+ */
+int dial_layout_sector_get(dial_layout_e layout, int x, int y)
+{
+	if (layout < 0 || layout >= DIAL_LAYOUT_COUNT)
+		return -1;
+
+	return s_layouts[layout].sector_get(x, y);
+}
+
+/*
+ * @brief Get the number of sectors of a layout over all its rings
+ * @param[in] layout Dial layout
+ */
+int dial_layout_targets_get(dial_layout_e layout)
+{
+	if (layout < 0 || layout >= DIAL_LAYOUT_COUNT)
+		return 0;
+
+	return s_layouts[layout].ring > 0 ? 2 * s_layouts[layout].sectors : s_layouts[layout].sectors;
+}
+
+/*
+ * @brief Get the centre of a sector relative to the dial, from 0.0 to 1.0
+ * @param[in] layout Dial layout
+ * @param[in] target Sector from 0 to dial_layout_targets_get() - 1
+ * @param[out] x X of the centre
+ * @param[out] y Y of the centre
+ */
+int dial_layout_center_get(dial_layout_e layout, int target, double *x, double *y)
+{
+	const struct dial_layout_info *info = NULL;
+	double radius = DIAL_SECTOR_CENTER_RADIUS;
+	double angle;
+
+	if (target < 0 || target >= dial_layout_targets_get(layout))
+		return -1;
+
+	info = &s_layouts[layout];
+	if (info->ring > 0)
+		radius = target < info->sectors ? (RADIUS_MIN + info->ring) / 2.0 : (info->ring + CENTER_REF_X) / 2.0;
+	angle = 2.0 * M_PI * (target % info->sectors) / info->sectors;
+
+	*x = (CENTER_REF_X + radius * sin(angle)) / (2.0 * CENTER_REF_X);
+	*y = (CENTER_REF_Y - radius * cos(angle)) / (2.0 * CENTER_REF_Y);
+
+	return 0;
+}
+
+/*
+ * @brief Get dial number of user's touch event position on the classic layout
+ * @param[in] evt_x X-coordinate value of event position
+ * @param[in] evt_y Y-coordinate value of event position
+ * Returns sector from 0 to DIAL_SECTOR_COUNT - 1, -1 inside RADIUS_MIN
+ */
+int dial_sector_get(int evt_x, int evt_y)
+{
+	return _dial_sector_get_DIAL_LAYOUT_10(evt_x, evt_y);
+}
+
+/*
+ * @brief Get the polar heatmap bin of the point, ring * DIAL_HEAT_ANGLE_BINS + angle bin
+ * Angle is a polynomial atan, within 0.001 degree, the same on every path
+ * @param[in] x X from the centre, right is positive
+ * @param[in] y Y from the centre, up is positive
+ */
+static unsigned short _dial_polar_get(float x, float y)
+{
+	float ax = fabsf(x);
+	float ay = fabsf(y);
+	float mn = ax < ay ? ax : ay;
+	float mx = ax < ay ? ay : ax;
+	float t = mx > 0.0f ? mn / mx : 0.0f;
+	float t2 = t * t;
+	float angle = t * (0.9998660f + t2 * (-0.3302995f + t2 * (0.1801410f + t2 * (-0.0851330f + t2 * 0.0208351f))));
+	int ring, sector;
+
+	/* Clockwise from the top */
+	if (ax > ay)
+		angle = DIAL_PI / 2.0f - angle;
+	if (y < 0.0f)
+		angle = DIAL_PI - angle;
+	if (x < 0.0f)
+		angle = 2.0f * DIAL_PI - angle;
+
+	sector = (int)(angle * (DIAL_HEAT_ANGLE_BINS / (2.0f * DIAL_PI)) + DIAL_HEAT_SECTOR_BINS / 2.0f);
+	if (sector >= DIAL_HEAT_ANGLE_BINS)
+		sector -= DIAL_HEAT_ANGLE_BINS;
+
+	ring = (int)(sqrtf(x * x + y * y) * (1.0f / DIAL_HEAT_RADIUS_STEP));
+	if (ring >= DIAL_HEAT_RADIUS_BINS)
+		ring = DIAL_HEAT_RADIUS_BINS - 1;
+
+	return (unsigned short)(ring * DIAL_HEAT_ANGLE_BINS + sector);
+}
+
+#if defined(__SSE2__)
+/*
+ * @brief Classify four points on the classic layout
+ * @param[in] px X of the points on screen
+ * @param[in] py Y of the points on screen
+ */
+static inline __m128i _dial_sector4(const int *px, const int *py)
+{
+	const __m128 sign = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+	__m128i x = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)px), _mm_set1_epi32(CENTER_REF_X));
+	__m128i y = _mm_sub_epi32(_mm_set1_epi32(CENTER_REF_Y), _mm_loadu_si128((const __m128i *)py));
+	__m128 xf = _mm_cvtepi32_ps(x);
+	__m128 yf = _mm_cvtepi32_ps(y);
+	__m128 xa = _mm_andnot_ps(sign, xf);
+	__m128i inside = _mm_castps_si128(_mm_cmple_ps(_mm_add_ps(_mm_mul_ps(xf, xf), _mm_mul_ps(yf, yf)),
+			_mm_set1_ps((float)(RADIUS_MIN * RADIUS_MIN))));
+	__m128i sector = _mm_setzero_si128();
+	__m128i mirror;
+	int k;
+
+	for (k = 0; k < DIAL_SECTOR_COUNT / 2; k++)
+		sector = _mm_sub_epi32(sector, _mm_castps_si128(_mm_cmpgt_ps(_mm_mul_ps(xa, _mm_set1_ps(s_DIAL_LAYOUT_10_bound[k][0])),
+				_mm_mul_ps(yf, _mm_set1_ps(s_DIAL_LAYOUT_10_bound[k][1])))));
+
+	/* Left half counts back from the top */
+	mirror = _mm_and_si128(_mm_cmplt_epi32(x, _mm_setzero_si128()), _mm_cmpgt_epi32(sector, _mm_setzero_si128()));
+	sector = _mm_or_si128(_mm_andnot_si128(mirror, sector),
+			_mm_and_si128(mirror, _mm_sub_epi32(_mm_set1_epi32(DIAL_SECTOR_COUNT), sector)));
+
+	return _mm_or_si128(sector, inside);
+}
+
+/*
+ * @brief Classify points, 16 at a time
+ */
+static int _dial_sector_simd(const int *x, const int *y, signed char *sector, int n)
+{
+	__m128i a, b;
+	int i;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		a = _mm_packs_epi32(_dial_sector4(x + i, y + i), _dial_sector4(x + i + 4, y + i + 4));
+		b = _mm_packs_epi32(_dial_sector4(x + i + 8, y + i + 8), _dial_sector4(x + i + 12, y + i + 12));
+		_mm_storeu_si128((__m128i *)(sector + i), _mm_packs_epi16(a, b));
+	}
+
+	return i;
+}
+
+/*
+ * @brief Polar bins of four points
+ */
+static inline __m128i _dial_polar4(const int *px, const int *py)
+{
+	const __m128 sign = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+	__m128 x = _mm_sub_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)px)), _mm_set1_ps(CENTER_REF_X));
+	__m128 y = _mm_sub_ps(_mm_set1_ps(CENTER_REF_Y), _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)py)));
+	__m128 ax = _mm_andnot_ps(sign, x);
+	__m128 ay = _mm_andnot_ps(sign, y);
+	__m128 mn = _mm_min_ps(ax, ay);
+	__m128 mx = _mm_max_ps(ax, ay);
+	__m128 zero = _mm_setzero_ps();
+	__m128 t = _mm_and_ps(_mm_div_ps(mn, mx), _mm_cmpgt_ps(mx, zero));
+	__m128 t2 = _mm_mul_ps(t, t);
+	__m128 angle, m;
+	__m128i sector, ring;
+
+	angle = _mm_add_ps(_mm_set1_ps(-0.0851330f), _mm_mul_ps(t2, _mm_set1_ps(0.0208351f)));
+	angle = _mm_add_ps(_mm_set1_ps(0.1801410f), _mm_mul_ps(t2, angle));
+	angle = _mm_add_ps(_mm_set1_ps(-0.3302995f), _mm_mul_ps(t2, angle));
+	angle = _mm_add_ps(_mm_set1_ps(0.9998660f), _mm_mul_ps(t2, angle));
+	angle = _mm_mul_ps(t, angle);
+
+	m = _mm_cmpgt_ps(ax, ay);
+	angle = _mm_or_ps(_mm_andnot_ps(m, angle), _mm_and_ps(m, _mm_sub_ps(_mm_set1_ps(DIAL_PI / 2.0f), angle)));
+	m = _mm_cmplt_ps(y, zero);
+	angle = _mm_or_ps(_mm_andnot_ps(m, angle), _mm_and_ps(m, _mm_sub_ps(_mm_set1_ps(DIAL_PI), angle)));
+	m = _mm_cmplt_ps(x, zero);
+	angle = _mm_or_ps(_mm_andnot_ps(m, angle), _mm_and_ps(m, _mm_sub_ps(_mm_set1_ps(2.0f * DIAL_PI), angle)));
+
+	sector = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(angle, _mm_set1_ps(DIAL_HEAT_ANGLE_BINS / (2.0f * DIAL_PI))),
+			_mm_set1_ps(DIAL_HEAT_SECTOR_BINS / 2.0f)));
+	sector = _mm_sub_epi32(sector, _mm_and_si128(_mm_cmpgt_epi32(sector, _mm_set1_epi32(DIAL_HEAT_ANGLE_BINS - 1)),
+			_mm_set1_epi32(DIAL_HEAT_ANGLE_BINS)));
+
+	ring = _mm_cvttps_epi32(_mm_mul_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))),
+			_mm_set1_ps(1.0f / DIAL_HEAT_RADIUS_STEP)));
+	m = _mm_castsi128_ps(_mm_cmpgt_epi32(ring, _mm_set1_epi32(DIAL_HEAT_RADIUS_BINS - 1)));
+	ring = _mm_or_si128(_mm_andnot_si128(_mm_castps_si128(m), ring),
+			_mm_and_si128(_mm_castps_si128(m), _mm_set1_epi32(DIAL_HEAT_RADIUS_BINS - 1)));
+
+	/* ring * 120 = ring * 128 - ring * 8 */
+	ring = _mm_sub_epi32(_mm_slli_epi32(ring, 7), _mm_slli_epi32(ring, 3));
+
+	return _mm_add_epi32(ring, sector);
+}
+
+/*
+ * @brief Polar bins of points, 8 at a time
+ */
+static int _dial_polar_simd(const int *x, const int *y, unsigned short *bin, int n)
+{
+	int i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+		_mm_storeu_si128((__m128i *)(bin + i), _mm_packs_epi32(_dial_polar4(x + i, y + i), _dial_polar4(x + i + 4, y + i + 4)));
+
+	return i;
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+/*
+ * @brief Classify four points on the classic layout
+ * @param[in] px X of the points on screen
+ * @param[in] py Y of the points on screen
+ */
+static inline int32x4_t _dial_sector4(const int *px, const int *py)
+{
+	int32x4_t x = vsubq_s32(vld1q_s32(px), vdupq_n_s32(CENTER_REF_X));
+	int32x4_t y = vsubq_s32(vdupq_n_s32(CENTER_REF_Y), vld1q_s32(py));
+	float32x4_t xf = vcvtq_f32_s32(x);
+	float32x4_t yf = vcvtq_f32_s32(y);
+	float32x4_t xa = vabsq_f32(xf);
+	uint32x4_t inside = vcleq_f32(vaddq_f32(vmulq_f32(xf, xf), vmulq_f32(yf, yf)), vdupq_n_f32((float)(RADIUS_MIN * RADIUS_MIN)));
+	int32x4_t sector = vdupq_n_s32(0);
+	uint32x4_t mirror;
+	int k;
+
+	for (k = 0; k < DIAL_SECTOR_COUNT / 2; k++)
+		sector = vsubq_s32(sector, vreinterpretq_s32_u32(vcgtq_f32(vmulq_n_f32(xa, s_DIAL_LAYOUT_10_bound[k][0]),
+				vmulq_n_f32(yf, s_DIAL_LAYOUT_10_bound[k][1]))));
+
+	/* Left half counts back from the top */
+	mirror = vandq_u32(vcltq_s32(x, vdupq_n_s32(0)), vcgtq_s32(sector, vdupq_n_s32(0)));
+	sector = vbslq_s32(mirror, vsubq_s32(vdupq_n_s32(DIAL_SECTOR_COUNT), sector), sector);
+
+	return vorrq_s32(sector, vreinterpretq_s32_u32(inside));
+}
+
+/*
+ * @brief Classify points, 16 at a time
+ */
+static int _dial_sector_simd(const int *x, const int *y, signed char *sector, int n)
+{
+	int16x8_t a, b;
+	int i;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		a = vcombine_s16(vqmovn_s32(_dial_sector4(x + i, y + i)), vqmovn_s32(_dial_sector4(x + i + 4, y + i + 4)));
+		b = vcombine_s16(vqmovn_s32(_dial_sector4(x + i + 8, y + i + 8)), vqmovn_s32(_dial_sector4(x + i + 12, y + i + 12)));
+		vst1q_s8(sector + i, vcombine_s8(vqmovn_s16(a), vqmovn_s16(b)));
+	}
+
+	return i;
+}
+
+/*
+ * @brief Polar bins of points, the atan is not vectorized on NEON
+ */
+static int _dial_polar_simd(const int *x, const int *y, unsigned short *bin, int n)
+{
+	return 0;
+}
+#else
+static int _dial_sector_simd(const int *x, const int *y, signed char *sector, int n)
+{
+	return 0;
+}
+
+static int _dial_polar_simd(const int *x, const int *y, unsigned short *bin, int n)
+{
+	return 0;
+}
+#endif
+
+/*
+ * @brief Classify arrays of points, same as dial_sector_get() on each
+ * @param[in] x X of the points on screen
+ * @param[in] y Y of the points on screen
+ * @param[out] sector Sector of each point, -1 inside RADIUS_MIN
+ * @param[in] n Number of points
+ */
+void dial_sector_batch(const int *x, const int *y, signed char *sector, int n)
+{
+	int i = _dial_sector_simd(x, y, sector, n);
+
+	for (; i < n; i++)
+		sector[i] = (signed char)dial_sector_get(x[i], y[i]);
+}
+
+/*
+ * @brief Get the polar heatmap bin of each point
+ * @param[in] x X of the points on screen
+ * @param[in] y Y of the points on screen
+ * @param[out] bin Bin of each point, ring * DIAL_HEAT_ANGLE_BINS + angle bin
+ * @param[in] n Number of points
+ */
+void dial_polar_batch(const int *x, const int *y, unsigned short *bin, int n)
+{
+	int i = _dial_polar_simd(x, y, bin, n);
+
+	for (; i < n; i++)
+		bin[i] = _dial_polar_get((float)(x[i] - CENTER_REF_X), (float)(CENTER_REF_Y - y[i]));
+}
+
+/*
+ * @brief Add points to the polar heatmap
+ * @param[in,out] heat Heatmap
+ * @param[in] x X of the points on screen
+ * @param[in] y Y of the points on screen
+ * @param[in] n Number of points
+ */
+void dial_heat_add(dial_heat_s *heat, const int *x, const int *y, int n)
+{
+	unsigned short bin[DIAL_BATCH_CHUNK];
+	unsigned int *bins = &heat->bins[0][0];
+	int i, k, m;
+
+	for (i = 0; i < n; i += m) {
+		m = n - i < DIAL_BATCH_CHUNK ? n - i : DIAL_BATCH_CHUNK;
+		dial_polar_batch(x + i, y + i, bin, m);
+		for (k = 0; k < m; k++)
+			bins[bin[k]]++;
+	}
+
+	heat->points += n;
+}
+
+/*
+ * @brief Count pairs of sectors, e.g. the sector at touch down against the one at lift
+ * @param[in,out] confusion Confusion matrix
+ * @param[in] row Sector of the row of each pair, -1 for none
+ * @param[in] col Sector of the column of each pair, -1 for none
+ * @param[in] n Number of pairs
+ */
+void dial_confusion_add(dial_confusion_s *confusion, const signed char *row, const signed char *col, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		confusion->cells[row[i] + 1][col[i] + 1]++;
+}
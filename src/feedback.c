@@ -0,0 +1,484 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Tap feedback. Cues are synthesized into PCM once at start, the output stream is opened once
+ * and kept open. The input path (single producer, main loop) queues cues through a lock-free ring,
+ * a mixer thread (single consumer) mixes active cues period by period into the sink
+ * and triggers the haptic motor for every cue it starts.
+ *
+ * Build with FEEDBACK_NO_DEVICE to leave out audio_io and haptics, tests/feedback_test.c
+ * builds it so on a host and checks the PCM written by the file sink.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <dlog.h>
+#if !defined(FEEDBACK_NO_DEVICE)
+#include <audio_io.h>
+#include <device/haptic.h>
+#endif
+#include "dialer.h"
+#include "feedback.h"
+
+/* One queued cue, the time is taken on the input path to measure latency */
+struct feedback_request {
+	unsigned char cue;
+	double time;
+};
+
+struct feedback_voice {
+	const short *pcm;
+	int frames;
+	int pos;
+};
+
+/* Output backend, write blocks for the duration of the PCM if paced is set */
+struct feedback_sink {
+	int (*open)(const char *path);
+	int (*write)(const short *pcm, int frames);
+	void (*close)(void);
+	int paced;
+};
+
+static int _null_open(const char *path);
+static int _null_write(const short *pcm, int frames);
+static void _null_close(void);
+static int _file_open(const char *path);
+static int _file_write(const short *pcm, int frames);
+static void _file_close(void);
+static int _audio_io_open(const char *path);
+static int _audio_io_write(const short *pcm, int frames);
+static void _audio_io_close(void);
+
+static const struct feedback_sink sinks[FEEDBACK_SINK_MAX] = {
+	{ _null_open, _null_write, _null_close, 0 },
+	{ _file_open, _file_write, _file_close, 0 },
+	{ _audio_io_open, _audio_io_write, _audio_io_close, 1 },
+};
+
+/* Tone and vibration of each cue */
+static const struct feedback_cue_desc {
+	float freq[2];
+	int ms;
+	float decay;
+	int haptic_ms;
+} cue_descs[FEEDBACK_CUE_MAX] = {
+	{ { 2000.0f, 2000.0f }, 15, 300.0f, 10 },
+	{ { 880.0f, 1320.0f }, 140, 20.0f, 30 },
+	{ { 220.0f, 165.0f }, 220, 10.0f, 120 },
+};
+
+static struct feedback_info {
+	short cues[FEEDBACK_CUE_MAX][FEEDBACK_CUE_FRAMES_MAX];
+	int cue_frames[FEEDBACK_CUE_MAX];
+
+	struct feedback_request ring[FEEDBACK_RING_SIZE];
+	/* head is written by the producer only, tail by the consumer only */
+	unsigned int head;
+	unsigned int tail;
+	unsigned int dropped;
+	unsigned int played;
+	unsigned int latency_max_us;
+
+	struct feedback_voice voices[FEEDBACK_VOICES];
+	short period[FEEDBACK_PERIOD];
+	const struct feedback_sink *sink;
+	FILE *fp;
+#if !defined(FEEDBACK_NO_DEVICE)
+	audio_out_h audio;
+	haptic_device_h haptic;
+#endif
+
+	sem_t sem;
+	pthread_t mixer;
+	int running;
+} s_info = {
+	.cue_frames = { 0, },
+
+	.head = 0,
+	.tail = 0,
+	.dropped = 0,
+	.played = 0,
+	.latency_max_us = 0,
+
+	.sink = NULL,
+	.fp = NULL,
+#if !defined(FEEDBACK_NO_DEVICE)
+	.audio = NULL,
+	.haptic = NULL,
+#endif
+
+	.running = 0,
+};
+
+/*
+ * @brief Get monotonic time in seconds
+ */
+static double _feedback_time_get(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+static int _null_open(const char *path)
+{
+	return 0;
+}
+
+static int _null_write(const short *pcm, int frames)
+{
+	return frames;
+}
+
+static void _null_close(void)
+{
+}
+
+static int _file_open(const char *path)
+{
+	if (path == NULL)
+		return -1;
+
+	s_info.fp = fopen(path, "wb");
+	return s_info.fp ? 0 : -1;
+}
+
+static int _file_write(const short *pcm, int frames)
+{
+	return (int)fwrite(pcm, sizeof(short), frames, s_info.fp);
+}
+
+static void _file_close(void)
+{
+	if (s_info.fp) {
+		fclose(s_info.fp);
+		s_info.fp = NULL;
+	}
+}
+
+#if !defined(FEEDBACK_NO_DEVICE)
+static int _audio_io_open(const char *path)
+{
+	if (audio_out_create(FEEDBACK_RATE, AUDIO_CHANNEL_MONO, AUDIO_SAMPLE_TYPE_S16_LE, SOUND_TYPE_MEDIA, &s_info.audio) != AUDIO_IO_ERROR_NONE)
+		return -1;
+
+	/* Stream stays prepared, a cue only costs a write */
+	if (audio_out_prepare(s_info.audio) != AUDIO_IO_ERROR_NONE) {
+		audio_out_destroy(s_info.audio);
+		s_info.audio = NULL;
+		return -1;
+	}
+
+	return 0;
+}
+
+static int _audio_io_write(const short *pcm, int frames)
+{
+	return audio_out_write(s_info.audio, (void *)pcm, frames * sizeof(short));
+}
+
+static void _audio_io_close(void)
+{
+	if (s_info.audio) {
+		audio_out_unprepare(s_info.audio);
+		audio_out_destroy(s_info.audio);
+		s_info.audio = NULL;
+	}
+}
+#else
+static int _audio_io_open(const char *path)
+{
+	return -1;
+}
+
+static int _audio_io_write(const short *pcm, int frames)
+{
+	return -1;
+}
+
+static void _audio_io_close(void)
+{
+}
+#endif
+
+/*
+ * @brief Synthesize every cue into its PCM buffer
+ * Two tones one after another with an exponential decay
+ */
+static void _feedback_cues_synthesize(void)
+{
+	const struct feedback_cue_desc *desc = NULL;
+	int cue;
+	int i;
+	int frames;
+	float t;
+	float freq;
+
+	for (cue = 0; cue < FEEDBACK_CUE_MAX; cue++) {
+		desc = &cue_descs[cue];
+		frames = desc->ms * FEEDBACK_RATE / 1000;
+		if (frames > FEEDBACK_CUE_FRAMES_MAX)
+			frames = FEEDBACK_CUE_FRAMES_MAX;
+
+		for (i = 0; i < frames; i++) {
+			t = (float)i / FEEDBACK_RATE;
+			freq = desc->freq[i < frames / 2 ? 0 : 1];
+			s_info.cues[cue][i] = (short)(12000.0f * expf(-desc->decay * t) * sinf(2.0f * (float)M_PI * freq * t));
+		}
+		s_info.cue_frames[cue] = frames;
+	}
+}
+
+/*
+ * @brief Start a voice for every queued cue and vibrate
+ * Returns number of cues started
+ */
+static int _feedback_drain(void)
+{
+	unsigned int head = __atomic_load_n(&s_info.head, __ATOMIC_ACQUIRE);
+	unsigned int tail = s_info.tail;
+	int started = (int)(head - tail);
+	unsigned int latency_us;
+	const struct feedback_request *request = NULL;
+	struct feedback_voice *voice = NULL;
+	double now;
+	int i;
+
+	if (head == tail)
+		return 0;
+
+	now = _feedback_time_get();
+
+	for (; tail != head; tail++) {
+		request = &s_info.ring[tail & (FEEDBACK_RING_SIZE - 1)];
+
+		/* Oldest voice is replaced when all are busy */
+		voice = &s_info.voices[0];
+		for (i = 0; i < FEEDBACK_VOICES; i++) {
+			if (s_info.voices[i].pcm == NULL || s_info.voices[i].pos > voice->pos)
+				voice = &s_info.voices[i];
+			if (voice->pcm == NULL)
+				break;
+		}
+		voice->pcm = s_info.cues[request->cue];
+		voice->frames = s_info.cue_frames[request->cue];
+		voice->pos = 0;
+
+#if !defined(FEEDBACK_NO_DEVICE)
+		if (s_info.haptic)
+			device_haptic_vibrate(s_info.haptic, cue_descs[request->cue].haptic_ms, 100, NULL);
+#endif
+
+		latency_us = (unsigned int)((now - request->time) * 1000000.0);
+		if (latency_us > s_info.latency_max_us)
+			__atomic_store_n(&s_info.latency_max_us, latency_us, __ATOMIC_RELAXED);
+		__atomic_store_n(&s_info.played, s_info.played + 1, __ATOMIC_RELAXED);
+	}
+
+	__atomic_store_n(&s_info.tail, tail, __ATOMIC_RELEASE);
+
+	return started;
+}
+
+/*
+ * @brief Mix one period of every active voice
+ * Returns number of voices still active
+ */
+static int _feedback_mix(void)
+{
+	struct feedback_voice *voice = NULL;
+	int active = 0;
+	int sum;
+	int i;
+	int j;
+
+	memset(s_info.period, 0, sizeof(s_info.period));
+
+	for (i = 0; i < FEEDBACK_VOICES; i++) {
+		voice = &s_info.voices[i];
+		if (voice->pcm == NULL)
+			continue;
+
+		for (j = 0; j < FEEDBACK_PERIOD && voice->pos < voice->frames; j++, voice->pos++) {
+			sum = s_info.period[j] + voice->pcm[voice->pos];
+			s_info.period[j] = (short)(sum > 32767 ? 32767 : (sum < -32768 ? -32768 : sum));
+		}
+
+		if (voice->pos >= voice->frames)
+			voice->pcm = NULL;
+		else
+			active++;
+	}
+
+	return active;
+}
+
+/*
+ * @brief Mixer thread, sleeps while nothing plays and writes period by period otherwise
+ * Sinks which do not block are paced by the clock like a device
+ * @param[in] data The data to be passed to the thread
+ */
+static void *_feedback_mixer(void *data)
+{
+	struct timespec next;
+	int active = 0;
+	long period_ns = 1000000000L / FEEDBACK_RATE * FEEDBACK_PERIOD;
+
+	while (__atomic_load_n(&s_info.running, __ATOMIC_ACQUIRE)) {
+		if (active == 0) {
+			sem_wait(&s_info.sem);
+			clock_gettime(CLOCK_MONOTONIC, &next);
+		}
+
+		/* Posts of cues already started while playing leave the semaphore ahead, nothing to write */
+		if (_feedback_drain() == 0 && active == 0)
+			continue;
+
+		active = _feedback_mix();
+		s_info.sink->write(s_info.period, FEEDBACK_PERIOD);
+
+		if (!s_info.sink->paced) {
+			next.tv_nsec += period_ns;
+			if (next.tv_nsec >= 1000000000L) {
+				next.tv_nsec -= 1000000000L;
+				next.tv_sec++;
+			}
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * @brief Synthesize cues, open the sink and start the mixer thread
+ * @param[in] sink Output backend
+ * @param[in] path Path of the PCM file for FEEDBACK_SINK_FILE, otherwise not used
+ */
+int feedback_start(feedback_sink_e sink, const char *path)
+{
+	if (s_info.running)
+		return 0;
+
+	if (sink < 0 || sink >= FEEDBACK_SINK_MAX)
+		return -1;
+
+	if (s_info.cue_frames[0] == 0)
+		_feedback_cues_synthesize();
+
+	s_info.sink = &sinks[sink];
+	if (s_info.sink->open(path)) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to open feedback sink %d.", sink);
+		return -1;
+	}
+
+#if !defined(FEEDBACK_NO_DEVICE)
+	/* Audio works without haptics */
+	if (device_haptic_open(0, &s_info.haptic) != DEVICE_ERROR_NONE)
+		s_info.haptic = NULL;
+#endif
+
+	memset(s_info.voices, 0, sizeof(s_info.voices));
+	sem_init(&s_info.sem, 0, 0);
+	s_info.running = 1;
+
+	if (pthread_create(&s_info.mixer, NULL, _feedback_mixer, NULL)) {
+		s_info.running = 0;
+		sem_destroy(&s_info.sem);
+		s_info.sink->close();
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Stop the mixer thread and close the sink, cues still playing are cut
+ */
+void feedback_stop(void)
+{
+	if (!s_info.running)
+		return;
+
+	__atomic_store_n(&s_info.running, 0, __ATOMIC_RELEASE);
+	sem_post(&s_info.sem);
+	pthread_join(s_info.mixer, NULL);
+
+	sem_destroy(&s_info.sem);
+	s_info.sink->close();
+
+#if !defined(FEEDBACK_NO_DEVICE)
+	if (s_info.haptic) {
+		device_haptic_close(s_info.haptic);
+		s_info.haptic = NULL;
+	}
+#endif
+}
+
+/*
+ * @brief Queue one cue, called on the input path
+ * Cue is dropped if the mixer is too far behind
+ * @param[in] cue Cue to be played
+ */
+void feedback_play(feedback_cue_e cue)
+{
+	unsigned int head = s_info.head;
+
+	if (!s_info.running || cue < 0 || cue >= FEEDBACK_CUE_MAX)
+		return;
+
+	if (head - __atomic_load_n(&s_info.tail, __ATOMIC_ACQUIRE) >= FEEDBACK_RING_SIZE) {
+		s_info.dropped++;
+		return;
+	}
+
+	s_info.ring[head & (FEEDBACK_RING_SIZE - 1)].cue = (unsigned char)cue;
+	s_info.ring[head & (FEEDBACK_RING_SIZE - 1)].time = _feedback_time_get();
+	__atomic_store_n(&s_info.head, head + 1, __ATOMIC_RELEASE);
+	sem_post(&s_info.sem);
+}
+
+/*
+ * @brief Get number of cues started by the mixer
+ */
+unsigned int feedback_played_get(void)
+{
+	return __atomic_load_n(&s_info.played, __ATOMIC_RELAXED);
+}
+
+/*
+ * @brief Get number of cues dropped because the ring was full
+ */
+unsigned int feedback_dropped_get(void)
+{
+	return s_info.dropped;
+}
+
+/*
+ * @brief Get the longest time from feedback_play() until the cue was mixed, in ms
+ */
+double feedback_latency_max_get(void)
+{
+	return __atomic_load_n(&s_info.latency_max_us, __ATOMIC_RELAXED) / 1000.0;
+}
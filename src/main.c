@@ -21,12 +21,101 @@
 #include <dlog.h>
 
 #include "dialer.h"
+#include "catalog.h"
 #include "view.h"
 #include "data.h"
+#include "perf.h"
+#include "trace.h"
+#include "reaction.h"
+#include "feedback.h"
 
 static void _btn_down_cb(void *data, Evas *e, Evas_Object *obj, void *event_info);
 static void _btn_up_cb(void *data, Evas *e, Evas_Object *obj, void *event_info);
 
+/*
+ * @brief Make the catalog of the locale active, e.g. locale/ko_KR.cat then locale/ko.cat, built-in English otherwise
+ * @param[in] locale Locale language of the system settings
+ */
+static void _app_catalog_load(const char *locale)
+{
+	char name[32] = { 0, };
+	char file[64] = { 0, };
+	char path[PATH_MAX] = { 0, };
+	char *sep = NULL;
+
+	snprintf(name, sizeof(name), "%s", locale);
+	sep = strchr(name, '.');
+	if (sep)
+		*sep = '\0';
+
+	snprintf(file, sizeof(file), "%s%s%s", CATALOG_DIR, name, CATALOG_SUFFIX);
+	data_get_full_path(file, path, (int)PATH_MAX);
+	if (!catalog_load(path))
+		return;
+
+	sep = strchr(name, '_');
+	if (sep) {
+		*sep = '\0';
+		snprintf(file, sizeof(file), "%s%s%s", CATALOG_DIR, name, CATALOG_SUFFIX);
+		data_get_full_path(file, path, (int)PATH_MAX);
+		if (!catalog_load(path))
+			return;
+	}
+
+	dlog_print(DLOG_INFO, LOG_TAG, "no catalog for %s, using built-in text", locale);
+	catalog_reset();
+}
+
+/*
+ * @brief Second stage of app_create, called once the first frame is on screen
+ * @param[in] data The data to be passed to the callback function
+ */
+static Eina_Bool _app_create_deferred_cb(void *data)
+{
+	char path[PATH_MAX] = { 0, };
+	char *locale = NULL;
+	int level = 0;
+	int best_score = 0;
+
+	/* Set Entry widget to "sw.entry.dial" part of EDC to display input dial number */
+	view_dialer_set_entry("sw.entry.dial");
+	//view_set_color(view_dialer_get_layout_object(), "sw.entry.dial", 250, 250, 250, 255);
+
+	/* Set full size Rectangle to catch circular dial button touch */
+	view_dialer_create_rectangle();
+
+	/* Only a few pages of the catalog are touched, the greeting is formatted from it */
+	if (system_settings_get_value_string(SYSTEM_SETTINGS_KEY_LOCALE_LANGUAGE, &locale) == SYSTEM_SETTINGS_ERROR_NONE && locale) {
+		_app_catalog_load(locale);
+		free(locale);
+	}
+	view_dialer_set_status(CATALOG_STR_GREETING, 0, 0);
+
+	/* Continue the game the process was killed in */
+	data_progress_get(&level, &best_score);
+	view_dialer_set_best_score(best_score);
+	if (level > 0)
+		view_dialer_set_level(level);
+
+	perf_mark(PERF_MARK_INTERACTIVE);
+	perf_startup_report();
+
+	/* Reaction time samples are written by a background thread */
+	data_get_data_path(REACTION_FILE, path, (int)PATH_MAX);
+	if (reaction_start(path))
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to open %s", path);
+
+	/* Output stream is opened once, taps only queue a cue */
+	if (feedback_start(FEEDBACK_SINK_AUDIO_IO, NULL))
+		feedback_start(FEEDBACK_SINK_NULL, NULL);
+
+	/* Decode the first level plate and warm font and edje caches while the user reads the greeting */
+	view_dialer_prefetch_next();
+	view_prewarm_start();
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
 /*
  * @brief Hook to take necessary actions before main event loop starts
  * @param[in] user_data The user data to be passed to the callback function
@@ -43,6 +132,12 @@ static bool app_create(void *user_data)
 
 	char *image = NULL;
 	char full_path[PATH_MAX] = { 0, };
+	double start = perf_cb_enter();
+
+	perf_mark(PERF_MARK_APP_CREATE);
+
+	/* Recover saved progress, only the tail of the log is read */
+	data_initialize();
 
 	/* Create main view */
 	view_create();
@@ -51,20 +146,120 @@ static bool app_create(void *user_data)
 
 	/* Set background image to "sw.button.bg" part of EDC */
 	image = data_get_image_path("sw.button.bg");
-	view_set_image(view_dialer_get_layout_object(), "sw.button.bg", image);
+	view_dialer_set_plate(image);
 	//view_set_color(view_dialer_get_layout_object(), "sw.button.bg", 8, 36, 61, 255);
 	free(image);
 
-	/* Set Entry widget to "sw.entry.dial" part of EDC to display input dial number */
-	view_dialer_set_entry("sw.entry.dial");
-	//view_set_color(view_dialer_get_layout_object(), "sw.entry.dial", 250, 250, 250, 255);
+	/* Everything else is not needed for the first frame.
+	 * Idlers run only after the first iteration has rendered the layout */
+	ecore_idler_add(_app_create_deferred_cb, NULL);
 
-	/* Set full size Rectangle to catch circular dial button touch */
-	view_dialer_create_rectangle();
+	perf_cb_leave(PERF_CB_APP_CREATE, start);
+	return true;
+}
+
+/*
+ * @brief Start or stop touch trace recording and replay as requested by launch request extras
+ * @param[in] app_control The handle to the app_control
+ * "trace.record" - "start" or "stop" recording to TRACE_FILE in the data directory
+ * "trace.replay" - file name in the data directory to replay, "trace.speed" - "max" or "original"
+ */
+static void _app_control_trace(app_control_h app_control)
+{
+	char *value = NULL;
+	char *speed = NULL;
+	char path[PATH_MAX] = { 0, };
 
-	view_dialer_set_entry_text(ENTRY_TEXT_SHOW, "Type any color to start");
+	if (app_control_get_extra_data(app_control, "trace.record", &value) == APP_CONTROL_ERROR_NONE && value) {
+		if (!strcmp(value, "start")) {
+			data_get_data_path(TRACE_FILE, path, (int)PATH_MAX);
+			if (trace_recorder_start(path))
+				dlog_print(DLOG_ERROR, LOG_TAG, "failed to record touch trace to %s", path);
+		} else {
+			trace_recorder_stop();
+		}
+		free(value);
+		value = NULL;
+	}
 
-	return true;
+	if (app_control_get_extra_data(app_control, "trace.replay", &value) == APP_CONTROL_ERROR_NONE && value) {
+		/* Only a bare file name of the data directory, nothing else can be reached */
+		if (value[0] == '\0' || strchr(value, '/') || strstr(value, "..") || !strcmp(value, ".")) {
+			dlog_print(DLOG_ERROR, LOG_TAG, "trace to replay must be a file name in the data directory: %s", value);
+			free(value);
+			return;
+		}
+
+		app_control_get_extra_data(app_control, "trace.speed", &speed);
+		data_get_data_path(value, path, (int)PATH_MAX);
+		view_dialer_replay_trace(path, speed && !strcmp(speed, "max"));
+		free(speed);
+		free(value);
+	}
+}
+
+/*
+ * @brief Queue automation commands given as launch request extras, for unattended performance runs
+ * @param[in] app_control The handle to the app_control
+ * "level" - level to jump to
+ * "tap" - "x,y" position of a synthetic tap, "tap.sector" - sector of a synthetic tap
+ * "bench" - "transitions" to show every level "bench.repeat" times, 1 by default
+ * "cache" - "reset" to flush image, font and edje caches
+ * "stats" - "dump" to write one line to DATA_STATS_DUMP_FILE in the data directory and dlog
+ * Commands run in this order, each after the previous one has finished
+ */
+static void _app_control_automation(app_control_h app_control)
+{
+	char *value = NULL;
+	int x = 0;
+	int y = 0;
+
+	if (app_control_get_extra_data(app_control, "cache", &value) == APP_CONTROL_ERROR_NONE && value) {
+		if (!strcmp(value, "reset"))
+			view_automation_queue(VIEW_AUTOMATION_CACHE_RESET, 0, 0);
+		free(value);
+		value = NULL;
+	}
+
+	if (app_control_get_extra_data(app_control, "level", &value) == APP_CONTROL_ERROR_NONE && value) {
+		view_automation_queue(VIEW_AUTOMATION_LEVEL, atoi(value), 0);
+		free(value);
+		value = NULL;
+	}
+
+	if (app_control_get_extra_data(app_control, "tap", &value) == APP_CONTROL_ERROR_NONE && value) {
+		if (sscanf(value, "%d,%d", &x, &y) == 2)
+			view_automation_queue(VIEW_AUTOMATION_TAP, x, y);
+		else
+			dlog_print(DLOG_ERROR, LOG_TAG, "tap must be x,y: %s", value);
+		free(value);
+		value = NULL;
+	}
+
+	if (app_control_get_extra_data(app_control, "tap.sector", &value) == APP_CONTROL_ERROR_NONE && value) {
+		view_automation_queue(VIEW_AUTOMATION_TAP_SECTOR, atoi(value), 0);
+		free(value);
+		value = NULL;
+	}
+
+	if (app_control_get_extra_data(app_control, "bench", &value) == APP_CONTROL_ERROR_NONE && value) {
+		char *repeat = NULL;
+
+		app_control_get_extra_data(app_control, "bench.repeat", &repeat);
+		if (!strcmp(value, "transitions"))
+			view_automation_queue(VIEW_AUTOMATION_BENCH_TRANSITIONS, repeat ? atoi(repeat) : 1, 0);
+		else
+			dlog_print(DLOG_ERROR, LOG_TAG, "unknown benchmark %s", value);
+		free(repeat);
+		free(value);
+		value = NULL;
+	}
+
+	if (app_control_get_extra_data(app_control, "stats", &value) == APP_CONTROL_ERROR_NONE && value) {
+		if (!strcmp(value, "dump"))
+			view_automation_queue(VIEW_AUTOMATION_STATS, 0, 0);
+		free(value);
+	}
 }
 
 /*
@@ -76,6 +271,12 @@ static bool app_create(void *user_data)
 static void app_control(app_control_h app_control, void *user_data)
 {
 	/* Handle the launch request. */
+	double start = perf_cb_enter();
+
+	_app_control_trace(app_control);
+	_app_control_automation(app_control);
+
+	perf_cb_leave(PERF_CB_APP_CONTROL, start);
 }
 
 /*
@@ -87,6 +288,14 @@ static void app_control(app_control_h app_control, void *user_data)
 static void app_pause(void *user_data)
 {
 	/* Take necessary actions when application becomes invisible. */
+	double start = perf_cb_enter();
+
+	view_pause();
+	trace_recorder_flush();
+	perf_cb_leave(PERF_CB_APP_PAUSE, start);
+
+	/* Stalls are printed off the interactive path */
+	perf_stall_dump();
 }
 
 /*
@@ -97,6 +306,10 @@ static void app_pause(void *user_data)
 static void app_resume(void *user_data)
 {
 	/* Take necessary actions when application becomes visible. */
+	double start = perf_cb_enter();
+
+	view_resume();
+	perf_cb_leave(PERF_CB_APP_RESUME, start);
 }
 
 /*
@@ -105,10 +318,21 @@ static void app_resume(void *user_data)
  */
 static void app_terminate(void *user_data)
 {
+	double start = perf_cb_enter();
+
 	/*
 	 * Destroy window component.
 	 */
 	view_destroy();
+	catalog_shutdown();
+	trace_recorder_stop();
+	reaction_stop();
+	feedback_stop();
+	data_finalize();
+
+	perf_cb_leave(PERF_CB_APP_TERMINATE, start);
+	perf_watchdog_stop();
+	perf_stall_dump();
 }
 
 /*
@@ -120,16 +344,40 @@ static void ui_app_lang_changed(app_event_info_h event_info, void *user_data)
 {
 	/*APP_EVENT_LANGUAGE_CHANGED*/
 	char *locale = NULL;
+	double start = perf_cb_enter();
 
 	system_settings_get_value_string(SYSTEM_SETTINGS_KEY_LOCALE_LANGUAGE, &locale);
 
 	if (locale != NULL) {
 		elm_language_set(locale);
+		/* Catalog is swapped, only the status text on screen is formatted again */
+		_app_catalog_load(locale);
+		view_dialer_refresh_status();
 		free(locale);
 	}
+
+	perf_cb_leave(PERF_CB_LANG_CHANGED, start);
 	return;
 }
 
+/*
+ * @brief This function will be called when the system runs out of memory
+ * @param[in] event_info The system event information
+ * @param[in] user_data The user data to be passed to the callback function
+ */
+static void ui_app_low_memory(app_event_info_h event_info, void *user_data)
+{
+	/*APP_EVENT_LOW_MEMORY*/
+	app_event_low_memory_status_e status = APP_EVENT_LOW_MEMORY_NORMAL;
+	double start = perf_cb_enter();
+
+	app_event_get_low_memory_status(event_info, &status);
+	dlog_print(DLOG_INFO, LOG_TAG, "low memory event, status %d", status);
+
+	view_low_memory();
+	perf_cb_leave(PERF_CB_LOW_MEMORY, start);
+}
+
 /*
  * @brief Main function of the application
  * @param[in] argc The argument count
@@ -139,6 +387,8 @@ int main(int argc, char *argv[])
 {
 	int ret;
 
+	perf_mark_process_start();
+
 	ui_app_lifecycle_callback_s event_callback = {0, };
 	app_event_handler_h handlers[5] = {NULL, };
 
@@ -153,6 +403,7 @@ int main(int argc, char *argv[])
 	 * Please check the application lifecycle guide
 	 */
 	ui_app_add_event_handler(&handlers[APP_EVENT_LANGUAGE_CHANGED], APP_EVENT_LANGUAGE_CHANGED, ui_app_lang_changed, NULL);
+	ui_app_add_event_handler(&handlers[APP_EVENT_LOW_MEMORY], APP_EVENT_LOW_MEMORY, ui_app_low_memory, NULL);
 
 	ret = ui_app_main(argc, argv, &event_callback, NULL);
 	if (ret != APP_ERROR_NONE) {
@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <dlog.h>
+#include <Elementary.h>
+#include "dialer.h"
+#include "perf.h"
+
+/* One recorded stall, kept small so the ring stays in a few cache lines */
+struct perf_stall {
+	unsigned int at_ms;
+	unsigned int duration_us;
+	unsigned char id;
+};
+
+static struct perf_info {
+	double marks[PERF_MARK_MAX];
+
+	Ecore_Idle_Exiter *loop_exiter;
+	Ecore_Idle_Enterer *loop_enterer;
+	Evas *evas;
+	double loop_start;
+	double render_start;
+	unsigned int wakeups;
+	unsigned int renders;
+
+	struct perf_stall stalls[PERF_STALL_RING_SIZE];
+	unsigned int stall_head;
+	unsigned int stall_dumped;
+} s_info = {
+	.marks = { 0.0, },
+
+	.loop_exiter = NULL,
+	.loop_enterer = NULL,
+	.evas = NULL,
+	.loop_start = 0.0,
+	.render_start = 0.0,
+	.wakeups = 0,
+	.renders = 0,
+
+	.stall_head = 0,
+	.stall_dumped = 0,
+};
+
+static const char *cb_names[PERF_CB_MAX] = {
+	"loop",
+	"render",
+	"mouse_down",
+	"mouse_up",
+	"mouse_move",
+	"longpress",
+	"text_resize",
+	"app_create",
+	"app_control",
+	"app_pause",
+	"app_resume",
+	"app_terminate",
+	"lang_changed",
+	"low_memory",
+	"frame",
+};
+
+static const char *mark_names[PERF_MARK_MAX] = {
+	"process_start",
+	"app_create",
+	"first_render",
+	"interactive",
+};
+
+/*
+ * @brief Get monotonic time in seconds, same clock as ecore_time_get()
+ */
+double perf_time_get(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/*
+ * @brief Record current time for the milestone, only the first call counts
+ * @param[in] mark The milestone to be recorded
+ */
+void perf_mark(perf_mark_e mark)
+{
+	if (mark < 0 || mark >= PERF_MARK_MAX)
+		return;
+
+	if (s_info.marks[mark] == 0.0)
+		s_info.marks[mark] = perf_time_get();
+}
+
+/*
+ * @brief Record process start time taken from the kernel
+ * Falls back to current time if /proc cannot be read
+ */
+void perf_mark_process_start(void)
+{
+	char buf[512] = { 0, };
+	unsigned long long start_ticks = 0;
+	struct timespec boot;
+	double age = 0.0;
+	long ticks_per_sec = sysconf(_SC_CLK_TCK);
+	char *p = NULL;
+	FILE *fp = fopen("/proc/self/stat", "r");
+
+	if (fp) {
+		if (fgets(buf, sizeof(buf), fp)) {
+			/* Skip "pid (comm)" first, comm may contain spaces */
+			p = strrchr(buf, ')');
+			if (p && ticks_per_sec > 0) {
+				/* starttime is the 20th field after comm */
+				if (sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu", &start_ticks) == 1) {
+					/* starttime counts from boot including suspend, convert it to the monotonic clock */
+					clock_gettime(CLOCK_BOOTTIME, &boot);
+					age = (double)boot.tv_sec + (double)boot.tv_nsec / 1000000000.0 - (double)start_ticks / (double)ticks_per_sec;
+					if (age >= 0.0)
+						s_info.marks[PERF_MARK_PROCESS_START] = perf_time_get() - age;
+				}
+			}
+		}
+		fclose(fp);
+	}
+
+	perf_mark(PERF_MARK_PROCESS_START);
+}
+
+/*
+ * @brief Get recorded time of the milestone, 0 if not recorded yet
+ * @param[in] mark The milestone
+ */
+double perf_mark_get(perf_mark_e mark)
+{
+	if (mark < 0 || mark >= PERF_MARK_MAX)
+		return 0.0;
+
+	return s_info.marks[mark];
+}
+
+/*
+ * @brief Print elapsed time of every milestone from process start
+ */
+void perf_startup_report(void)
+{
+	int i;
+	double start = s_info.marks[PERF_MARK_PROCESS_START];
+
+	for (i = PERF_MARK_APP_CREATE; i < PERF_MARK_MAX; i++) {
+		if (s_info.marks[i] == 0.0)
+			continue;
+
+		dlog_print(DLOG_INFO, LOG_TAG, "startup %s +%.1f ms", mark_names[i], (s_info.marks[i] - start) * 1000.0);
+	}
+}
+
+/*
+ * @brief Take the start timestamp of a timed callback
+ */
+double perf_cb_enter(void)
+{
+	return perf_time_get();
+}
+
+/*
+ * @brief Record the callback into the stall ring if it took longer than a frame
+ * @param[in] id Id of the callback
+ * @param[in] start Timestamp returned by perf_cb_enter()
+ */
+void perf_cb_leave(perf_cb_e id, double start)
+{
+	struct perf_stall *stall = NULL;
+	double now = perf_time_get();
+	double duration = now - start;
+
+	if (duration < PERF_STALL_THRESHOLD || start == 0.0)
+		return;
+
+	stall = &s_info.stalls[s_info.stall_head & (PERF_STALL_RING_SIZE - 1)];
+	stall->at_ms = (unsigned int)(now * 1000.0);
+	stall->duration_us = (unsigned int)(duration * 1000000.0);
+	stall->id = (unsigned char)id;
+	s_info.stall_head++;
+}
+
+/*
+ * @brief Function will be operated when the main loop wakes up
+ * @param[in] data The data to be passed to the callback function
+ */
+static Eina_Bool _loop_exiter_cb(void *data)
+{
+	s_info.loop_start = perf_cb_enter();
+	s_info.wakeups++;
+
+	return ECORE_CALLBACK_RENEW;
+}
+
+/*
+ * @brief Function will be operated when the main loop is about to sleep
+ * Registered after ecore_evas, so the render of this iteration is included
+ * @param[in] data The data to be passed to the callback function
+ */
+static Eina_Bool _loop_enterer_cb(void *data)
+{
+	perf_cb_leave(PERF_CB_LOOP, s_info.loop_start);
+	s_info.loop_start = 0.0;
+
+	return ECORE_CALLBACK_RENEW;
+}
+
+/*
+ * @brief Function will be operated before the canvas is rendered
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] e The handle to an Evas canvas to be passed to the callback function
+ * @param[in] event_info The system event information
+ */
+static void _render_pre_cb(void *data, Evas *e, void *event_info)
+{
+	s_info.render_start = perf_cb_enter();
+}
+
+/*
+ * @brief Function will be operated after the canvas is rendered
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] e The handle to an Evas canvas to be passed to the callback function
+ * @param[in] event_info The system event information
+ */
+static void _render_post_cb(void *data, Evas *e, void *event_info)
+{
+	perf_cb_leave(PERF_CB_RENDER, s_info.render_start);
+	s_info.render_start = 0.0;
+	s_info.renders++;
+}
+
+/*
+ * @brief Start timing every main loop iteration and every render of the canvas
+ * @param[in] evas Canvas of the main window
+ */
+void perf_watchdog_start(Evas *evas)
+{
+	if (s_info.loop_exiter == NULL)
+		s_info.loop_exiter = ecore_idle_exiter_add(_loop_exiter_cb, NULL);
+
+	if (s_info.loop_enterer == NULL)
+		s_info.loop_enterer = ecore_idle_enterer_add(_loop_enterer_cb, NULL);
+
+	if (evas && s_info.evas == NULL) {
+		s_info.evas = evas;
+		evas_event_callback_add(evas, EVAS_CALLBACK_RENDER_PRE, _render_pre_cb, NULL);
+		evas_event_callback_add(evas, EVAS_CALLBACK_RENDER_POST, _render_post_cb, NULL);
+	}
+}
+
+/*
+ * @brief Stop the watchdog
+ */
+void perf_watchdog_stop(void)
+{
+	if (s_info.loop_exiter) {
+		ecore_idle_exiter_del(s_info.loop_exiter);
+		s_info.loop_exiter = NULL;
+	}
+
+	if (s_info.loop_enterer) {
+		ecore_idle_enterer_del(s_info.loop_enterer);
+		s_info.loop_enterer = NULL;
+	}
+
+	if (s_info.evas) {
+		evas_event_callback_del_full(s_info.evas, EVAS_CALLBACK_RENDER_PRE, _render_pre_cb, NULL);
+		evas_event_callback_del_full(s_info.evas, EVAS_CALLBACK_RENDER_POST, _render_post_cb, NULL);
+		s_info.evas = NULL;
+	}
+}
+
+/*
+ * @brief Get number of stalls recorded since start
+ */
+int perf_stall_count_get(void)
+{
+	return (int)s_info.stall_head;
+}
+
+/*
+ * @brief Get wakeup and render counters, counted while the watchdog runs
+ * @param[out] activity Counters and the current time
+ */
+void perf_activity_get(perf_activity_s *activity)
+{
+	if (activity == NULL)
+		return;
+
+	activity->wakeups = s_info.wakeups;
+	activity->renders = s_info.renders;
+	activity->time = perf_time_get();
+}
+
+/*
+ * @brief Print wakeups and renders per minute since a snapshot taken by perf_activity_get()
+ * @param[in] what Name of the period, e.g. "idle"
+ * @param[in] since Snapshot taken at the start of the period
+ */
+void perf_activity_report(const char *what, const perf_activity_s *since)
+{
+	perf_activity_s now;
+	double minutes;
+
+	if (since == NULL || since->time == 0.0)
+		return;
+
+	perf_activity_get(&now);
+	minutes = (now.time - since->time) / 60.0;
+	if (minutes <= 0.0)
+		return;
+
+	dlog_print(DLOG_INFO, LOG_TAG, "%s %.1f s: %.1f wakeups/min %.1f renders/min", what, minutes * 60.0,
+			(now.wakeups - since->wakeups) / minutes, (now.renders - since->renders) / minutes);
+}
+
+/*
+ * @brief Print stalls recorded since the last dump
+ */
+void perf_stall_dump(void)
+{
+	const struct perf_stall *stall = NULL;
+	unsigned int i = s_info.stall_dumped;
+
+	/* Older entries are already overwritten */
+	if (s_info.stall_head - i > PERF_STALL_RING_SIZE)
+		i = s_info.stall_head - PERF_STALL_RING_SIZE;
+
+	for (; i != s_info.stall_head; i++) {
+		stall = &s_info.stalls[i & (PERF_STALL_RING_SIZE - 1)];
+		dlog_print(DLOG_WARN, LOG_TAG, "stall %s %u.%03u ms at %u", cb_names[stall->id],
+				stall->duration_us / 1000, stall->duration_us % 1000, stall->at_ms);
+	}
+
+	s_info.stall_dumped = s_info.stall_head;
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Indexed plates: a palette of at most 256 colours and runs of palette indices, see tools/plate_index.c.
+ * A plate is about a tenth of its PNG after decoding to a run list, and a run list expands
+ * straight into the evas image buffer without a decoder. Palette variants share the runs.
+ * Expansion looks up each run once and fills it with vector stores.
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+#include "plate.h"
+
+/*
+ * @brief Check if the image is an indexed plate by its suffix
+ * @param[in] path Path of the image
+ */
+int plate_path_is_indexed(const char *path)
+{
+	size_t len = strlen(path);
+
+	return len >= sizeof(PLATE_SUFFIX) - 1 && !strcmp(path + len - (sizeof(PLATE_SUFFIX) - 1), PLATE_SUFFIX);
+}
+
+/*
+ * @brief Check that runs fill the plate row by row with indices of the palette
+ * Expansion trusts the plate after this
+ * @param[in] plate Mapped plate
+ */
+static int _plate_check(const plate_s *plate)
+{
+	const plate_header_s *header = plate->header;
+	unsigned int i;
+	int x = 0;
+	int y = 0;
+
+	for (i = 0; i < header->runs; i++) {
+		if (plate->runs[i].index >= header->colours || y >= header->height)
+			return -1;
+
+		x += plate->runs[i].length + 1;
+		if (x > header->width)
+			return -1;
+		if (x == header->width) {
+			x = 0;
+			y++;
+		}
+	}
+
+	return y == header->height ? 0 : -1;
+}
+
+/*
+ * @brief Map an indexed plate, pages of the file are read in here
+ * @param[out] plate Plate to be opened
+ * @param[in] path Path of the plate
+ */
+int plate_open(plate_s *plate, const char *path)
+{
+	const plate_header_s *header = NULL;
+	struct stat st;
+	void *map = NULL;
+	size_t size;
+	int fd;
+
+	memset(plate, 0, sizeof(*plate));
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return -1;
+
+	if (fstat(fd, &st) || st.st_size < (off_t)sizeof(plate_header_s)) {
+		close(fd);
+		return -1;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return -1;
+
+	header = map;
+	size = sizeof(*header) + (size_t)header->variants * header->colours * sizeof(unsigned int)
+			+ (size_t)header->runs * sizeof(plate_run_s);
+	if (header->magic != PLATE_MAGIC || header->version != PLATE_VERSION
+			|| header->width == 0 || header->height == 0
+			|| header->colours == 0 || header->colours > PLATE_COLOURS_MAX
+			|| header->variants == 0 || header->variants > PLATE_VARIANTS_MAX
+			|| size != (size_t)st.st_size) {
+		munmap(map, st.st_size);
+		return -1;
+	}
+
+	plate->map = map;
+	plate->size = st.st_size;
+	plate->header = header;
+	plate->palettes = (const unsigned int *)(header + 1);
+	plate->runs = (const plate_run_s *)(plate->palettes + header->variants * header->colours);
+
+	if (_plate_check(plate)) {
+		plate_close(plate);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Unmap the plate
+ * @param[in] plate Opened plate, closing it again does nothing
+ */
+void plate_close(plate_s *plate)
+{
+	if (plate->map)
+		munmap(plate->map, plate->size);
+	memset(plate, 0, sizeof(*plate));
+}
+
+/*
+ * @brief Fill pixels with one colour
+ * @param[out] dst First pixel
+ * @param[in] colour ARGB colour
+ * @param[in] len Number of pixels
+ */
+static inline void _plate_fill(unsigned int *dst, unsigned int colour, int len)
+{
+#if defined(__SSE2__)
+	__m128i v = _mm_set1_epi32((int)colour);
+
+	for (; len >= 8; len -= 8, dst += 8) {
+		_mm_storeu_si128((__m128i *)dst, v);
+		_mm_storeu_si128((__m128i *)(dst + 4), v);
+	}
+	if (len >= 4) {
+		_mm_storeu_si128((__m128i *)dst, v);
+		len -= 4;
+		dst += 4;
+	}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	uint32x4_t v = vdupq_n_u32(colour);
+
+	for (; len >= 8; len -= 8, dst += 8) {
+		vst1q_u32(dst, v);
+		vst1q_u32(dst + 4, v);
+	}
+	if (len >= 4) {
+		vst1q_u32(dst, v);
+		len -= 4;
+		dst += 4;
+	}
+#endif
+	while (len-- > 0)
+		*dst++ = colour;
+}
+
+/*
+ * @brief Expand the plate to ARGB premultiplied pixels, e.g. right into evas image data
+ * @param[in] plate Opened plate
+ * @param[in] variant Palette variant, from 0 to variants - 1
+ * @param[out] dst Pixels of width x height
+ * @param[in] stride Pixels from one row to the next, at least width
+ */
+int plate_expand(const plate_s *plate, int variant, unsigned int *dst, int stride)
+{
+	const plate_header_s *header = plate->header;
+	const unsigned int *palette = NULL;
+	const plate_run_s *run = NULL;
+	const plate_run_s *end = NULL;
+	int x = 0;
+	int len;
+
+	if (header == NULL || variant < 0 || variant >= header->variants || stride < header->width)
+		return -1;
+
+	palette = plate->palettes + variant * header->colours;
+	end = plate->runs + header->runs;
+	for (run = plate->runs; run < end; run++) {
+		len = run->length + 1;
+		_plate_fill(dst + x, palette[run->index], len);
+		x += len;
+		if (x == header->width) {
+			x = 0;
+			dst += stride;
+		}
+	}
+
+	return 0;
+}
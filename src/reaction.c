@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Reaction time samples go from the input path (single producer, main loop)
+ * to a writer thread (single consumer) through a lock-free ring.
+ * The producer never takes a lock, it only does two atomic accesses and a sem_post.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include "reaction.h"
+
+static struct reaction_info {
+	reaction_sample_s ring[REACTION_RING_SIZE];
+	/* head is written by the producer only, tail by the consumer only */
+	unsigned int head;
+	unsigned int tail;
+	unsigned int dropped;
+
+	sem_t sem;
+	pthread_t writer;
+	int running;
+	FILE *fp;
+} s_info = {
+	.head = 0,
+	.tail = 0,
+	.dropped = 0,
+	.running = 0,
+	.fp = NULL,
+};
+
+/*
+ * @brief Write every queued sample to the file
+ */
+static void _reaction_drain(void)
+{
+	unsigned int head = __atomic_load_n(&s_info.head, __ATOMIC_ACQUIRE);
+	unsigned int tail = s_info.tail;
+	const reaction_sample_s *sample = NULL;
+	struct timespec now;
+
+	if (head == tail)
+		return;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+
+	for (; tail != head; tail++) {
+		sample = &s_info.ring[tail & (REACTION_RING_SIZE - 1)];
+		fprintf(s_info.fp, "%ld,%u,%u,%d,%u.%03u\n", (long)now.tv_sec, sample->level, sample->answer,
+				sample->tapped, sample->reaction_us / 1000, sample->reaction_us % 1000);
+	}
+
+	/* Slots can be reused only after they are written out */
+	__atomic_store_n(&s_info.tail, tail, __ATOMIC_RELEASE);
+	fflush(s_info.fp);
+}
+
+/*
+ * @brief Writer thread persisting samples whenever the producer signals
+ * @param[in] data The data to be passed to the thread
+ */
+static void *_reaction_writer(void *data)
+{
+	while (__atomic_load_n(&s_info.running, __ATOMIC_ACQUIRE)) {
+		sem_wait(&s_info.sem);
+		_reaction_drain();
+	}
+
+	_reaction_drain();
+
+	return NULL;
+}
+
+/*
+ * @brief Start the writer thread appending samples to the file
+ * @param[in] path Path of the samples file
+ */
+int reaction_start(const char *path)
+{
+	if (s_info.running)
+		return 0;
+
+	s_info.fp = fopen(path, "a");
+	if (s_info.fp == NULL)
+		return -1;
+
+	sem_init(&s_info.sem, 0, 0);
+	s_info.running = 1;
+
+	if (pthread_create(&s_info.writer, NULL, _reaction_writer, NULL)) {
+		s_info.running = 0;
+		sem_destroy(&s_info.sem);
+		fclose(s_info.fp);
+		s_info.fp = NULL;
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Flush queued samples and stop the writer thread
+ */
+void reaction_stop(void)
+{
+	if (!s_info.running)
+		return;
+
+	__atomic_store_n(&s_info.running, 0, __ATOMIC_RELEASE);
+	sem_post(&s_info.sem);
+	pthread_join(s_info.writer, NULL);
+
+	sem_destroy(&s_info.sem);
+	fclose(s_info.fp);
+	s_info.fp = NULL;
+}
+
+/*
+ * @brief Queue one sample, called on the input path
+ * Sample is dropped if the writer is too far behind
+ * @param[in] sample Sample to be queued
+ */
+void reaction_push(const reaction_sample_s *sample)
+{
+	unsigned int head = s_info.head;
+
+	if (!s_info.running)
+		return;
+
+	if (head - __atomic_load_n(&s_info.tail, __ATOMIC_ACQUIRE) >= REACTION_RING_SIZE) {
+		s_info.dropped++;
+		return;
+	}
+
+	s_info.ring[head & (REACTION_RING_SIZE - 1)] = *sample;
+	__atomic_store_n(&s_info.head, head + 1, __ATOMIC_RELEASE);
+	sem_post(&s_info.sem);
+}
+
+/*
+ * @brief Get number of samples dropped because the ring was full
+ */
+unsigned int reaction_dropped_get(void)
+{
+	return s_info.dropped;
+}
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Next plate is picked by difficulty around the skill of the player.
+ * Plates are ordered by difficulty, each difficulty is a bucket of consecutive positions.
+ * A Fenwick tree over the positions counts the plates which can be picked,
+ * so picking the k-th plate of a bucket and excluding or releasing a plate is O(log n).
+ * The bucket is picked from a fixed window around the target, which doesn't grow with the pool.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sampler.h"
+
+static struct sampler_info {
+	int count;
+	unsigned char *difficulty;
+	/* Plate at each position, and position of each plate */
+	int *order;
+	int *pos;
+	/* First position of each bucket, plates of the bucket which can be picked */
+	int bucket_start[SAMPLER_DIFFICULTY_MAX + 2];
+	int bucket_avail[SAMPLER_DIFFICULTY_MAX + 1];
+	/* Fenwick tree of positions, 1 if the plate can be picked, 1-based */
+	int *tree;
+	int tree_mask;
+
+	/* Recently shown plates, excluded until they drop out of the ring */
+	unsigned char *excluded;
+	int recent[SAMPLER_RECENT];
+	unsigned int recent_head;
+	unsigned int recent_len;
+	unsigned int recent_cap;
+
+	double skill;
+	unsigned int rand;
+} s_info = {
+	.count = 0,
+	.difficulty = NULL,
+	.order = NULL,
+	.pos = NULL,
+	.tree = NULL,
+	.tree_mask = 0,
+
+	.excluded = NULL,
+	.recent_head = 0,
+	.recent_len = 0,
+	.recent_cap = 0,
+
+	.skill = SAMPLER_SKILL_INIT,
+	.rand = 1,
+};
+
+/*
+ * @brief Get next number of the xorshift generator
+ */
+static unsigned int _sampler_rand(void)
+{
+	unsigned int x = s_info.rand;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	s_info.rand = x;
+
+	return x;
+}
+
+/*
+ * @brief Add to the value of a position in the Fenwick tree
+ * @param[in] pos Position, from 0
+ * @param[in] delta Value to be added
+ */
+static void _sampler_tree_add(int pos, int delta)
+{
+	for (pos++; pos <= s_info.count; pos += pos & -pos)
+		s_info.tree[pos] += delta;
+}
+
+/*
+ * @brief Get number of plates which can be picked before the position
+ * @param[in] pos Position, from 0
+ */
+static int _sampler_tree_prefix(int pos)
+{
+	int sum = 0;
+
+	for (; pos > 0; pos -= pos & -pos)
+		sum += s_info.tree[pos];
+
+	return sum;
+}
+
+/*
+ * @brief Find the position of the k-th plate which can be picked
+ * @param[in] k Number of plates which can be picked before it, from 0
+ */
+static int _sampler_tree_find(int k)
+{
+	int pos = 0;
+	int mask = 0;
+
+	for (mask = s_info.tree_mask; mask; mask >>= 1) {
+		if (pos + mask <= s_info.count && s_info.tree[pos + mask] <= k) {
+			pos += mask;
+			k -= s_info.tree[pos];
+		}
+	}
+
+	return pos;
+}
+
+/*
+ * @brief Allow or disallow picking of the plate
+ * @param[in] plate Index of the plate
+ * @param[in] excluded 1 to disallow picking
+ */
+static void _sampler_exclude(int plate, int excluded)
+{
+	if (s_info.excluded[plate] == excluded)
+		return;
+
+	s_info.excluded[plate] = (unsigned char)excluded;
+	s_info.bucket_avail[s_info.difficulty[plate]] += excluded ? -1 : 1;
+	_sampler_tree_add(s_info.pos[plate], excluded ? -1 : 1);
+}
+
+/*
+ * @brief Build the index over the plates
+ * @param[in] difficulty Difficulty of each plate, from 0 to SAMPLER_DIFFICULTY_MAX
+ * @param[in] count Number of plates
+ * @param[in] seed Seed of the random picks
+ */
+int sampler_init(const unsigned char *difficulty, int count, unsigned int seed)
+{
+	int next[SAMPLER_DIFFICULTY_MAX + 1] = { 0, };
+	int i = 0;
+	int b = 0;
+	int parent = 0;
+
+	sampler_fini();
+	if (count < 1)
+		return -1;
+
+	s_info.difficulty = malloc(count * sizeof(s_info.difficulty[0]));
+	s_info.order = malloc(count * sizeof(s_info.order[0]));
+	s_info.pos = malloc(count * sizeof(s_info.pos[0]));
+	s_info.tree = calloc(count + 1, sizeof(s_info.tree[0]));
+	s_info.excluded = calloc(count, sizeof(s_info.excluded[0]));
+	if (s_info.difficulty == NULL || s_info.order == NULL || s_info.pos == NULL
+			|| s_info.tree == NULL || s_info.excluded == NULL) {
+		sampler_fini();
+		return -1;
+	}
+
+	s_info.count = count;
+	memset(s_info.bucket_avail, 0, sizeof(s_info.bucket_avail));
+	for (i = 0; i < count; i++) {
+		s_info.difficulty[i] = difficulty[i] > SAMPLER_DIFFICULTY_MAX ? SAMPLER_DIFFICULTY_MAX : difficulty[i];
+		s_info.bucket_avail[s_info.difficulty[i]]++;
+	}
+
+	/* Counting sort by difficulty, stable so equal plates keep their order */
+	s_info.bucket_start[0] = 0;
+	for (b = 0; b <= SAMPLER_DIFFICULTY_MAX; b++) {
+		s_info.bucket_start[b + 1] = s_info.bucket_start[b] + s_info.bucket_avail[b];
+		next[b] = s_info.bucket_start[b];
+	}
+	for (i = 0; i < count; i++) {
+		s_info.pos[i] = next[s_info.difficulty[i]]++;
+		s_info.order[s_info.pos[i]] = i;
+	}
+
+	/* Every plate can be picked, the tree is built bottom up in O(n) */
+	for (i = 1; i <= count; i++) {
+		s_info.tree[i] += 1;
+		parent = i + (i & -i);
+		if (parent <= count)
+			s_info.tree[parent] += s_info.tree[i];
+	}
+	for (s_info.tree_mask = 1; s_info.tree_mask * 2 <= count; s_info.tree_mask *= 2)
+		;
+
+	/* At least half of the pool stays available */
+	s_info.recent_head = 0;
+	s_info.recent_len = 0;
+	s_info.recent_cap = (unsigned int)(count / 2) < SAMPLER_RECENT ? (unsigned int)(count / 2) : SAMPLER_RECENT;
+
+	s_info.rand = seed ? seed : 1;
+
+	return 0;
+}
+
+/*
+ * @brief Free the index
+ */
+void sampler_fini(void)
+{
+	free(s_info.difficulty);
+	free(s_info.order);
+	free(s_info.pos);
+	free(s_info.tree);
+	free(s_info.excluded);
+
+	s_info.difficulty = NULL;
+	s_info.order = NULL;
+	s_info.pos = NULL;
+	s_info.tree = NULL;
+	s_info.excluded = NULL;
+	s_info.count = 0;
+}
+
+/*
+ * @brief Pick a plate for the skill
+ * Plates near the target are more likely, each is weighted by its distance in buckets.
+ * If the window has nothing to pick, the nearest bucket with a plate is used
+ * @param[in] skill Skill of the player
+ * Returns index of the plate, -1 if there is no plate
+ */
+int sampler_pick(double skill)
+{
+	int weight[2 * SAMPLER_WINDOW + 1] = { 0, };
+	int target = 0;
+	int total = 0;
+	int b = 0;
+	int d = 0;
+	int r = 0;
+
+	if (s_info.count < 1)
+		return -1;
+
+	target = (int)lround(skill - SAMPLER_TARGET_MARGIN);
+	if (target < 0)
+		target = 0;
+	else if (target > SAMPLER_DIFFICULTY_MAX)
+		target = SAMPLER_DIFFICULTY_MAX;
+
+	for (d = -SAMPLER_WINDOW; d <= SAMPLER_WINDOW; d++) {
+		b = target + d;
+		if (b < 0 || b > SAMPLER_DIFFICULTY_MAX)
+			continue;
+
+		weight[d + SAMPLER_WINDOW] = s_info.bucket_avail[b] * (SAMPLER_WINDOW + 1 - abs(d));
+		total += weight[d + SAMPLER_WINDOW];
+	}
+
+	if (total > 0) {
+		r = (int)(_sampler_rand() % (unsigned int)total);
+		for (d = 0; r >= weight[d]; d++)
+			r -= weight[d];
+		b = target + d - SAMPLER_WINDOW;
+	} else {
+		for (d = SAMPLER_WINDOW + 1; d <= SAMPLER_DIFFICULTY_MAX; d++) {
+			if (target - d >= 0 && s_info.bucket_avail[target - d] > 0) {
+				b = target - d;
+				break;
+			}
+			if (target + d <= SAMPLER_DIFFICULTY_MAX && s_info.bucket_avail[target + d] > 0) {
+				b = target + d;
+				break;
+			}
+		}
+		if (d > SAMPLER_DIFFICULTY_MAX)
+			return -1;
+	}
+
+	/* Uniform among the plates of the bucket which can be picked */
+	r = (int)(_sampler_rand() % (unsigned int)s_info.bucket_avail[b]);
+
+	return s_info.order[_sampler_tree_find(_sampler_tree_prefix(s_info.bucket_start[b]) + r)];
+}
+
+/*
+ * @brief Exclude the plate shown from the next picks
+ * The oldest recently shown plate can be picked again
+ * @param[in] plate Index of the plate
+ */
+void sampler_shown(int plate)
+{
+	if (plate < 0 || plate >= s_info.count || s_info.recent_cap == 0 || s_info.excluded[plate])
+		return;
+
+	if (s_info.recent_len == s_info.recent_cap) {
+		_sampler_exclude(s_info.recent[s_info.recent_head & (SAMPLER_RECENT - 1)], 0);
+		s_info.recent_head++;
+		s_info.recent_len--;
+	}
+
+	_sampler_exclude(plate, 1);
+	s_info.recent[(s_info.recent_head + s_info.recent_len) & (SAMPLER_RECENT - 1)] = plate;
+	s_info.recent_len++;
+}
+
+/*
+ * @brief Get the skill after an answer, an Elo style update on the difficulty scale
+ * @param[in] skill Skill before the answer
+ * @param[in] difficulty Difficulty of the plate
+ * @param[in] right 1 if the answer was right
+ */
+double sampler_skill_update(double skill, int difficulty, int right)
+{
+	double expected = 1.0 / (1.0 + exp((difficulty - skill) / SAMPLER_SKILL_SCALE));
+
+	if (right)
+		skill += SAMPLER_SKILL_K * (1.0 - expected);
+	else
+		skill -= SAMPLER_SKILL_K * expected;
+
+	if (skill < 0.0)
+		return 0.0;
+	if (skill > SAMPLER_DIFFICULTY_MAX)
+		return SAMPLER_DIFFICULTY_MAX;
+
+	return skill;
+}
+
+/*
+ * @brief Update the skill with the answer of the plate
+ * @param[in] plate Index of the plate
+ * @param[in] right 1 if the answer was right
+ */
+void sampler_answer(int plate, int right)
+{
+	if (plate < 0 || plate >= s_info.count)
+		return;
+
+	s_info.skill = sampler_skill_update(s_info.skill, s_info.difficulty[plate], right);
+}
+
+/*
+ * @brief Get the skill of the player
+ */
+double sampler_skill_get(void)
+{
+	return s_info.skill;
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Disk cache of level select thumbnails. Only libc is used here, every function may run in a worker thread.
+ * A thumbnail is keyed by the hash of the plate file, a plate changed by an update gets a new one.
+ * Files are written to a temporary name and renamed, a crash never leaves a torn thumbnail behind.
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "thumb.h"
+
+#define THUMB_READ_CHUNK 16384
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+/*
+ * @brief Get the FNV-1a hash of a file
+ * @param[in] path Path of the file
+ * Returns the hash, 0 if the file cannot be read
+ */
+unsigned long long thumb_file_hash(const char *path)
+{
+	unsigned char buf[THUMB_READ_CHUNK];
+	unsigned long long hash = FNV_OFFSET;
+	ssize_t len, i;
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0)
+		return 0;
+
+	while ((len = read(fd, buf, sizeof(buf))) > 0) {
+		for (i = 0; i < len; i++) {
+			hash ^= buf[i];
+			hash *= FNV_PRIME;
+		}
+	}
+	close(fd);
+
+	if (len < 0)
+		return 0;
+
+	/* 0 is the error */
+	return hash ? hash : 1;
+}
+
+/*
+ * @brief Get the path of the cached thumbnail of a plate
+ * @param[in] dir Cache directory with the trailing slash
+ * @param[in] hash Hash of the plate file
+ * @param[out] path Path of the thumbnail
+ * @param[in] len Size of path
+ */
+void thumb_cache_path(const char *dir, unsigned long long hash, char *path, int len)
+{
+	snprintf(path, len, "%s%016llx%s", dir, hash, THUMB_SUFFIX);
+}
+
+/*
+ * @brief Read a cached thumbnail
+ * @param[in] path Path of the thumbnail
+ * @param[in] hash Hash of the plate file, must match the one the thumbnail was made from
+ * @param[out] pixels THUMB_SIZE * THUMB_SIZE pixels
+ */
+int thumb_cache_load(const char *path, unsigned long long hash, unsigned int *pixels)
+{
+	thumb_header_s header;
+	size_t len = THUMB_SIZE * THUMB_SIZE * sizeof(*pixels);
+	int fd = open(path, O_RDONLY);
+	int ret = -1;
+
+	if (fd < 0)
+		return -1;
+
+	if (read(fd, &header, sizeof(header)) == (ssize_t)sizeof(header)
+			&& header.magic == THUMB_MAGIC && header.version == THUMB_VERSION
+			&& header.size == THUMB_SIZE && header.hash == hash
+			&& read(fd, pixels, len) == (ssize_t)len)
+		ret = 0;
+	close(fd);
+
+	return ret;
+}
+
+/*
+ * @brief Write a thumbnail to the cache
+ * @param[in] path Path of the thumbnail
+ * @param[in] hash Hash of the plate file
+ * @param[in] pixels THUMB_SIZE * THUMB_SIZE pixels
+ */
+int thumb_cache_save(const char *path, unsigned long long hash, const unsigned int *pixels)
+{
+	thumb_header_s header = {
+		.magic = THUMB_MAGIC,
+		.version = THUMB_VERSION,
+		.size = THUMB_SIZE,
+		.hash = hash,
+	};
+	char tmp[PATH_MAX];
+	size_t len = THUMB_SIZE * THUMB_SIZE * sizeof(*pixels);
+	int fd;
+	int ret = -1;
+
+	/* Unique per thread, two cells of the same plate may be generating at once */
+	if (snprintf(tmp, sizeof(tmp), "%s.%lx.tmp", path, (unsigned long)pthread_self()) >= (int)sizeof(tmp))
+		return -1;
+
+	fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0)
+		return -1;
+
+	if (write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) && write(fd, pixels, len) == (ssize_t)len)
+		ret = 0;
+
+	if (close(fd) || ret || rename(tmp, path)) {
+		unlink(tmp);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Scale an image down to a thumbnail, each thumbnail pixel is the mean of the pixels it covers
+ * Premultiplied pixels average right, no unpremultiply is needed
+ * An image smaller than THUMB_SIZE is scaled up, each thumbnail pixel covers at least one pixel,
+ * an empty image gives a transparent thumbnail
+ * @param[in] src ARGB pixels of the image
+ * @param[in] w Width of the image
+ * @param[in] h Height of the image
+ * @param[in] stride Pixels from one row of the image to the next
+ * @param[out] dst THUMB_SIZE * THUMB_SIZE pixels
+ */
+void thumb_scale(const unsigned int *src, int w, int h, int stride, unsigned int *dst)
+{
+	unsigned int sum[THUMB_SIZE][4];
+	int x0[THUMB_SIZE];
+	int x1[THUMB_SIZE];
+	int tx, ty, x, y, y0, y1, n, c;
+
+	if (w < 1 || h < 1) {
+		memset(dst, 0, THUMB_SIZE * THUMB_SIZE * sizeof(*dst));
+		return;
+	}
+
+	for (tx = 0; tx < THUMB_SIZE; tx++) {
+		x0[tx] = tx * w / THUMB_SIZE;
+		x1[tx] = (tx + 1) * w / THUMB_SIZE;
+		if (x1[tx] <= x0[tx])
+			x1[tx] = x0[tx] + 1;
+	}
+
+	for (ty = 0; ty < THUMB_SIZE; ty++) {
+		y0 = ty * h / THUMB_SIZE;
+		y1 = (ty + 1) * h / THUMB_SIZE;
+		if (y1 <= y0)
+			y1 = y0 + 1;
+		memset(sum, 0, sizeof(sum));
+
+		for (y = y0; y < y1; y++) {
+			const unsigned int *row = src + (size_t)y * stride;
+
+			for (tx = 0; tx < THUMB_SIZE; tx++) {
+				for (x = x0[tx]; x < x1[tx]; x++) {
+					sum[tx][0] += row[x] >> 24;
+					sum[tx][1] += (row[x] >> 16) & 0xff;
+					sum[tx][2] += (row[x] >> 8) & 0xff;
+					sum[tx][3] += row[x] & 0xff;
+				}
+			}
+		}
+
+		for (tx = 0; tx < THUMB_SIZE; tx++) {
+			n = (x1[tx] - x0[tx]) * (y1 - y0);
+			for (c = 0; c < 4; c++)
+				sum[tx][c] = (sum[tx][c] + n / 2) / n;
+			dst[ty * THUMB_SIZE + tx] = sum[tx][0] << 24 | sum[tx][1] << 16 | sum[tx][2] << 8 | sum[tx][3];
+		}
+	}
+}
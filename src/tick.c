@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+#include <limits.h>
+#include <math.h>
+#include <dlog.h>
+#include <Elementary.h>
+#include "dialer.h"
+#include "perf.h"
+#include "tick.h"
+
+static struct tick_info {
+	tick_timer_s *wheel[TICK_WHEEL_SIZE];
+	int count;
+
+	Ecore_Animator *animator;
+	/* Wakes the animator for a far deadline, the loop sleeps in between */
+	Ecore_Timer *park;
+	/* Last tick processed, ticks are frames counted on the loop clock */
+	long long tick;
+	int wakeups;
+
+	tick_cb frame_end_cb;
+	void *frame_end_data;
+} s_info = {
+	.wheel = { NULL, },
+	.count = 0,
+
+	.animator = NULL,
+	.park = NULL,
+	.tick = 0,
+	.wakeups = 0,
+
+	.frame_end_cb = NULL,
+	.frame_end_data = NULL,
+};
+
+static Eina_Bool _tick_animator_cb(void *data);
+
+/*
+ * @brief Convert time on the loop clock to the nearest frame
+ * @param[in] time Time in seconds
+ */
+static long long _tick_tick_get(double time)
+{
+	return llround(time / ecore_animator_frametime_get());
+}
+
+/*
+ * @brief Unlink timer from its wheel slot
+ * @param[in] timer Timer to be unlinked
+ */
+static void _tick_unlink(tick_timer_s *timer)
+{
+	if (timer->next)
+		timer->next->pprev = timer->pprev;
+	*timer->pprev = timer->next;
+
+	timer->next = NULL;
+	timer->pprev = NULL;
+	s_info.count--;
+}
+
+/*
+ * @brief Arm or re-arm the timer, the callback is called once on the first frame at or after the deadline
+ * Nothing is allocated, timers live in the caller's state
+ * @param[in] timer Timer to be armed
+ * @param[in] delay Delay from the current loop time in seconds
+ * @param[in] cb Callback to be called on expiry
+ * @param[in] data The data to be passed to the callback function
+ */
+void tick_timer_add(tick_timer_s *timer, double delay, tick_cb cb, void *data)
+{
+	tick_timer_s **slot = NULL;
+	double now = ecore_loop_time_get();
+
+	if (timer == NULL || cb == NULL)
+		return;
+
+	if (timer->pprev)
+		_tick_unlink(timer);
+
+	timer->deadline = now + (delay > 0.0 ? delay : 0.0);
+	timer->tick = _tick_tick_get(timer->deadline);
+	timer->cb = cb;
+	timer->data = data;
+
+	/* Anything due now runs on the next frame. While parked the wheel still
+	 * holds timers behind the loop clock, the animator catches up on them */
+	if (s_info.count == 0)
+		s_info.tick = _tick_tick_get(now);
+	if (timer->tick <= s_info.tick)
+		timer->tick = s_info.tick + 1;
+
+	slot = &s_info.wheel[timer->tick & (TICK_WHEEL_SIZE - 1)];
+	timer->next = *slot;
+	if (timer->next)
+		timer->next->pprev = &timer->next;
+	timer->pprev = slot;
+	*slot = timer;
+	s_info.count++;
+
+	/* Animator decides on the next frame whether to park again */
+	if (s_info.park) {
+		ecore_timer_del(s_info.park);
+		s_info.park = NULL;
+	}
+	if (s_info.animator == NULL)
+		s_info.animator = ecore_animator_add(_tick_animator_cb, NULL);
+}
+
+/*
+ * @brief Disarm the timer, does nothing if it is not pending
+ * @param[in] timer Timer to be disarmed
+ */
+void tick_timer_del(tick_timer_s *timer)
+{
+	if (timer == NULL || timer->pprev == NULL)
+		return;
+
+	_tick_unlink(timer);
+}
+
+/*
+ * @brief Check if the timer is armed
+ * @param[in] timer Timer to be checked
+ */
+Eina_Bool tick_timer_pending(const tick_timer_s *timer)
+{
+	return timer && timer->pprev;
+}
+
+/*
+ * @brief Get time left until the deadline of a pending timer, 0 if it is not pending
+ * @param[in] timer Timer to be checked
+ */
+double tick_timer_remaining_get(const tick_timer_s *timer)
+{
+	double remaining;
+
+	if (!tick_timer_pending(timer))
+		return 0.0;
+
+	remaining = timer->deadline - ecore_loop_time_get();
+	return remaining > 0.0 ? remaining : 0.0;
+}
+
+/*
+ * @brief Set the function called once after all timers of a frame have fired
+ * Callbacks only mark state dirty, the UI is updated here once per frame
+ * @param[in] cb Function to be called, NULL to unset
+ * @param[in] data The data to be passed to the callback function
+ */
+void tick_frame_end_cb_set(tick_cb cb, void *data)
+{
+	s_info.frame_end_cb = cb;
+	s_info.frame_end_data = data;
+}
+
+/*
+ * @brief Get number of frames in which the scheduler woke up
+ */
+int tick_wakeup_count_get(void)
+{
+	return s_info.wakeups;
+}
+
+/*
+ * @brief Fire every timer of the slot which is due by the tick
+ * Timers for later turns of the wheel stay in the slot
+ * @param[in] slot Index of the slot
+ * @param[in] tick Current tick
+ */
+static void _tick_slot_run(unsigned int slot, long long tick)
+{
+	tick_timer_s *timer = s_info.wheel[slot];
+	tick_timer_s *next = NULL;
+
+	while (timer) {
+		next = timer->next;
+		if (timer->tick <= tick) {
+			_tick_unlink(timer);
+			/* Callback may re-arm this timer or delete the next one */
+			timer->cb(timer->data);
+			next = s_info.wheel[slot];
+		}
+		timer = next;
+	}
+}
+
+/*
+ * @brief Get the tick of the earliest pending timer
+ */
+static long long _tick_next_get(void)
+{
+	tick_timer_s *timer = NULL;
+	long long next = LLONG_MAX;
+	unsigned int i;
+
+	for (i = 0; i < TICK_WHEEL_SIZE; i++)
+		for (timer = s_info.wheel[i]; timer; timer = timer->next)
+			if (timer->tick < next)
+				next = timer->tick;
+
+	return next;
+}
+
+/*
+ * @brief Function will be operated when the parked wheel is due again
+ * @param[in] data The data to be passed to the callback function
+ */
+static Eina_Bool _tick_park_cb(void *data)
+{
+	s_info.park = NULL;
+
+	if (s_info.animator == NULL)
+		s_info.animator = ecore_animator_add(_tick_animator_cb, NULL);
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
+/*
+ * @brief Function will be operated on every frame while a timer is pending
+ * @param[in] data The data to be passed to the callback function
+ */
+static Eina_Bool _tick_animator_cb(void *data)
+{
+	double start = perf_cb_enter();
+	long long now = _tick_tick_get(ecore_loop_time_get());
+	long long tick = s_info.tick;
+	long long next;
+
+	s_info.wakeups++;
+
+	/* Timers armed from callbacks go to the next frame at the earliest */
+	s_info.tick = now;
+
+	/* A long stall went around the whole wheel, every slot is visited once */
+	if (now - tick > TICK_WHEEL_SIZE)
+		tick = now - TICK_WHEEL_SIZE;
+
+	for (tick = tick + 1; tick <= now; tick++)
+		_tick_slot_run((unsigned int)(tick & (TICK_WHEEL_SIZE - 1)), now);
+
+	if (s_info.frame_end_cb)
+		s_info.frame_end_cb(s_info.frame_end_data);
+
+	perf_cb_leave(PERF_CB_FRAME, start);
+
+	if (s_info.count == 0) {
+		s_info.animator = NULL;
+		return ECORE_CALLBACK_CANCEL;
+	}
+
+	/* Nothing due for a while, e.g. the idle timeout. One timer wakeup instead of a frame each */
+	next = _tick_next_get();
+	if (next - now > TICK_PARK_FRAMES) {
+		s_info.park = ecore_timer_add((next - now - 1) * ecore_animator_frametime_get(), _tick_park_cb, NULL);
+		if (s_info.park) {
+			s_info.animator = NULL;
+			return ECORE_CALLBACK_CANCEL;
+		}
+	}
+
+	return ECORE_CALLBACK_RENEW;
+}
+
+/*
+ * @brief Disarm all timers and stop the animator
+ */
+void tick_shutdown(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < TICK_WHEEL_SIZE; i++)
+		while (s_info.wheel[i])
+			_tick_unlink(s_info.wheel[i]);
+
+	if (s_info.animator) {
+		ecore_animator_del(s_info.animator);
+		s_info.animator = NULL;
+	}
+
+	if (s_info.park) {
+		ecore_timer_del(s_info.park);
+		s_info.park = NULL;
+	}
+
+	s_info.frame_end_cb = NULL;
+	s_info.frame_end_data = NULL;
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Only libc is used here, so host tools can read and write traces too.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+/* Recorder output goes through a big stdio buffer, no syscall per event */
+#define TRACE_WRITE_BUFFER_SIZE (16 * 1024)
+
+static struct trace_info {
+	FILE *fp;
+	char *write_buf;
+	trace_event_s last;
+} s_info = {
+	.fp = NULL,
+	.write_buf = NULL,
+	.last = { 0, },
+};
+
+/*
+ * @brief Write unsigned varint
+ * @param[out] out Output buffer, needs 5 bytes at most
+ * @param[in] value Value to be written
+ */
+static int _varint_put(unsigned char *out, unsigned int value)
+{
+	int len = 0;
+
+	while (value >= 0x80) {
+		out[len++] = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	out[len++] = (unsigned char)value;
+
+	return len;
+}
+
+/*
+ * @brief Read unsigned varint
+ * @param[in] reader Reader to read from
+ * @param[out] value Read value
+ */
+static int _varint_get(trace_reader_s *reader, unsigned int *value)
+{
+	unsigned int result = 0;
+	int shift = 0;
+	unsigned char byte;
+
+	do {
+		if (reader->pos >= reader->len || shift > 28)
+			return -1;
+
+		byte = reader->buf[reader->pos++];
+		result |= (unsigned int)(byte & 0x7f) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+
+	*value = result;
+
+	return 0;
+}
+
+/*
+ * @brief Encode one event relative to the previous one
+ * @param[out] out Output buffer of TRACE_EVENT_SIZE_MAX bytes
+ * @param[in] ev Event to be encoded
+ * @param[in] prev Previous event
+ */
+int trace_event_encode(unsigned char *out, const trace_event_s *ev, const trace_event_s *prev)
+{
+	int len = 0;
+	int dx = ev->x - prev->x;
+	int dy = ev->y - prev->y;
+
+	out[len++] = (unsigned char)ev->type;
+	len += _varint_put(out + len, ev->timestamp - prev->timestamp);
+	/* Zigzag keeps small negative deltas small */
+	len += _varint_put(out + len, ((unsigned int)dx << 1) ^ (unsigned int)(dx >> 31));
+	len += _varint_put(out + len, ((unsigned int)dy << 1) ^ (unsigned int)(dy >> 31));
+
+	return len;
+}
+
+/*
+ * @brief Start recording touch events to the file
+ * @param[in] path Path of the trace file
+ */
+int trace_recorder_start(const char *path)
+{
+	unsigned char header[TRACE_HEADER_SIZE] = { 'G', 'E', 'T', 'R', TRACE_VERSION };
+
+	if (s_info.fp)
+		trace_recorder_stop();
+
+	s_info.fp = fopen(path, "wb");
+	if (s_info.fp == NULL)
+		return -1;
+
+	s_info.write_buf = malloc(TRACE_WRITE_BUFFER_SIZE);
+	if (s_info.write_buf)
+		setvbuf(s_info.fp, s_info.write_buf, _IOFBF, TRACE_WRITE_BUFFER_SIZE);
+
+	memset(&s_info.last, 0, sizeof(s_info.last));
+	fwrite(header, 1, sizeof(header), s_info.fp);
+
+	return 0;
+}
+
+/*
+ * @brief Check whether touch events are being recorded
+ */
+int trace_recorder_is_running(void)
+{
+	return s_info.fp != NULL;
+}
+
+/*
+ * @brief Append one touch event to the trace, cheap no-op if not recording
+ * @param[in] type TRACE_EVENT_DOWN, TRACE_EVENT_MOVE or TRACE_EVENT_UP
+ * @param[in] x X-coordinate value of event position
+ * @param[in] y Y-coordinate value of event position
+ * @param[in] timestamp Event timestamp in ms
+ */
+void trace_recorder_add(int type, int x, int y, unsigned int timestamp)
+{
+	unsigned char out[TRACE_EVENT_SIZE_MAX];
+	trace_event_s ev = { type, x, y, timestamp };
+	int len;
+
+	if (s_info.fp == NULL)
+		return;
+
+	/* First event is stored with an absolute timestamp */
+	len = trace_event_encode(out, &ev, &s_info.last);
+	fwrite(out, 1, len, s_info.fp);
+	s_info.last = ev;
+}
+
+/*
+ * @brief Push buffered events to the file
+ */
+void trace_recorder_flush(void)
+{
+	if (s_info.fp)
+		fflush(s_info.fp);
+}
+
+/*
+ * @brief Stop recording and close the trace file
+ */
+void trace_recorder_stop(void)
+{
+	if (s_info.fp == NULL)
+		return;
+
+	fclose(s_info.fp);
+	s_info.fp = NULL;
+
+	free(s_info.write_buf);
+	s_info.write_buf = NULL;
+}
+
+/*
+ * @brief Load a whole trace file into memory for replay
+ * @param[out] reader Reader to be initialized
+ * @param[in] path Path of the trace file
+ */
+int trace_reader_open(trace_reader_s *reader, const char *path)
+{
+	FILE *fp = NULL;
+	long size;
+
+	memset(reader, 0, sizeof(*reader));
+
+	fp = fopen(path, "rb");
+	if (fp == NULL)
+		return -1;
+
+	if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) < TRACE_HEADER_SIZE) {
+		fclose(fp);
+		return -1;
+	}
+	rewind(fp);
+
+	reader->buf = malloc(size);
+	if (reader->buf == NULL || fread(reader->buf, 1, size, fp) != (size_t)size
+			|| memcmp(reader->buf, TRACE_MAGIC, 4) || reader->buf[4] != TRACE_VERSION) {
+		fclose(fp);
+		trace_reader_close(reader);
+		return -1;
+	}
+	fclose(fp);
+
+	reader->len = size;
+	reader->pos = TRACE_HEADER_SIZE;
+
+	return 0;
+}
+
+/*
+ * @brief Decode next event
+ * @param[in] reader Opened reader
+ * @param[out] ev Decoded event
+ * Returns 1 if an event is decoded, 0 at the end of the trace, -1 on a broken trace
+ */
+int trace_reader_next(trace_reader_s *reader, trace_event_s *ev)
+{
+	unsigned int dt, zx, zy;
+
+	if (reader->pos >= reader->len)
+		return 0;
+
+	ev->type = reader->buf[reader->pos++];
+	if (ev->type > TRACE_EVENT_UP || _varint_get(reader, &dt) || _varint_get(reader, &zx) || _varint_get(reader, &zy))
+		return -1;
+
+	ev->timestamp = reader->last.timestamp + dt;
+	ev->x = reader->last.x + (int)((zx >> 1) ^ (0u - (zx & 1)));
+	ev->y = reader->last.y + (int)((zy >> 1) ^ (0u - (zy & 1)));
+	reader->last = *ev;
+
+	return 1;
+}
+
+/*
+ * @brief Go back to the first event
+ * @param[in] reader Opened reader
+ */
+void trace_reader_rewind(trace_reader_s *reader)
+{
+	reader->pos = TRACE_HEADER_SIZE;
+	memset(&reader->last, 0, sizeof(reader->last));
+}
+
+/*
+ * @brief Free the reader
+ * @param[in] reader Reader to be freed
+ */
+void trace_reader_close(trace_reader_s *reader)
+{
+	free(reader->buf);
+	memset(reader, 0, sizeof(*reader));
+}
@@ -14,14 +14,29 @@
  * limitations under the License.
  */ 
 
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/stat.h>
 #include <tizen.h>
 #include <dlog.h>
 #include <app.h>
 #include <efl_extension.h>
 #include <Elementary.h>
 #include "dialer.h"
+#include "catalog.h"
 #include "view.h"
+#include "dial.h"
 #include "data.h"
+#include "perf.h"
+#include "trace.h"
+#include "reaction.h"
+#include "tick.h"
+#include "feedback.h"
+#include "sampler.h"
+#include "thumb.h"
+#include "plate.h"
 
 static struct view_info {
 	Evas_Object *win;
@@ -29,111 +44,341 @@ static struct view_info {
 	Evas_Object *layout;
 
 	Evas_Object *entry;
-	Ecore_Timer *timer;
+	const char *entry_style;
+
+	/* Every timed behaviour runs on the frame scheduler */
+	tick_timer_s longpress;
+
+	/* Hidden image object used to decode the next plate ahead of time, or the next indexed plate mapped */
+	Evas_Object *prefetch;
+	plate_s prefetch_plate;
+	char prefetch_path[PATH_MAX];
+	Ecore_Job *restore_job;
+	tick_timer_s prefetch_timer;
+
+	/* Idle-time prewarm of glyphs, plates and edje parts */
+	Ecore_Idler *prewarm_idler;
+	Ecore_Evas *prewarm_ee;
+	unsigned int prewarm_step;
+
+	/* Touch trace replay */
+	trace_reader_s replay;
+	tick_timer_s replay_timer;
+	Eina_Bool replay_max_speed;
+	double replay_start;
+	unsigned int replay_first_ts;
+	trace_event_s replay_event;
+
+	/* Path of the plate currently swallowed in "sw.button.bg" */
+	char plate_path[PATH_MAX];
+	int plate_variant;
+	Eina_Bool plate_released;
+	/* Plate of the previous level in "sw.button.bg.out", faded out over the new one */
+	Evas_Object *plate_out;
+	/* Plate image object out of the layout, swallowed again by the next level */
+	Evas_Object *plate_spare;
+	/* Crossfade runs on the frames of the tick wheel, re-armed every frame */
+	tick_timer_s transition;
+	double transition_start;
+	Eina_Bool paused;
+	double resume_time;
+
+	/* Reaction time: plate appearance and answering touch on the monotonic clock */
+	double plate_shown;
+	Eina_Bool plate_render_armed;
+	double mouse_down_time;
+	double input_skew;
+	/* Reaction time of each level of the current run in ms, for the leaderboard */
+	unsigned int run_times[DATA_STATS_LEVEL_MAX + 1];
+
+	/* Dial layout of the plate shown, the centre of each of its sectors relative to the layout is the drag value of "sw.touch.anchor" */
+	dial_layout_e dial_layout;
+	double sector_center[DIAL_LAYOUT_TARGETS_MAX][2];
+
+	/* Time attack, the countdown of a plate starts on the frame which shows it */
+	Eina_Bool time_attack;
+	tick_timer_s countdown;
+	tick_timer_s countdown_tick;
+	double countdown_deadline;
+	double countdown_left;
+	int countdown_seconds;
+	Eina_Bool status_dirty;
+	int time_attack_best;
+
+	/* Idle mode, edje is paused and the canvas is rendered only on demand */
+	tick_timer_s idle_timer;
+	Eina_Bool idle;
+	perf_activity_s idle_activity;
+
+	/* Stats are collected in a job, never on the input path */
+	Ecore_Job *stats_job;
+
+	/* Automation commands run one after another in the main loop */
+	struct automation_command {
+		view_automation_e command;
+		int a;
+		int b;
+	} automation[VIEW_AUTOMATION_QUEUE_SIZE];
+	unsigned int automation_head;
+	unsigned int automation_tail;
+	Eina_Bool automation_busy;
+	Ecore_Job *automation_job;
+	tick_timer_s automation_timer;
+
+	/* Level transition benchmark, time from setting a level to the frame which shows it */
+	unsigned int bench_us[VIEW_BENCH_SAMPLES_MAX];
+	int bench_count;
+	int bench_total;
+	double bench_start;
+	int bench_rss_start;
 
 	int mouse_down_dial_num;
 	int level;
 	int total_level;
+	int best_score;
+
+	/* Plate of the level on screen, and the next one picked ahead by difficulty to be decoded in the background */
+	int plate;
+	int plate_next;
+	int plate_count;
+
+	/* Status string on screen with its numbers, formatted again on language change */
+	catalog_str_e status;
+	int status_args[CATALOG_ARGS_MAX];
+
+	/* Level select, a gengrid on top of the touch layer which realizes only the visible cells */
+	Evas_Object *select;
+	Elm_Gengrid_Item_Class *select_itc;
+	Ecore_Job *select_job;
+	Eina_Bool select_armed;
+	/* Thumbnail cache directory, and hash of each plate file once it is known */
+	char thumb_dir[PATH_MAX];
+	unsigned long long thumb_hash[VIEW_PLATE_MAX];
 } s_info = {
 	.win = NULL,
 	.conform = NULL,
 	.layout = NULL,
 
 	.entry = NULL,
-	.timer = NULL,
+	.entry_style = NULL,
+
+	.longpress = { 0, },
+
+	.prefetch = NULL,
+	.prefetch_plate = { 0, },
+	.prefetch_path = { 0, },
+	.restore_job = NULL,
+	.prefetch_timer = { 0, },
+
+	.prewarm_idler = NULL,
+	.prewarm_ee = NULL,
+	.prewarm_step = 0,
+
+	.replay = { 0, },
+	.replay_timer = { 0, },
+	.replay_max_speed = EINA_FALSE,
+	.replay_start = 0.0,
+	.replay_first_ts = 0,
+	.replay_event = { 0, },
+
+	.plate_path = { 0, },
+	.plate_variant = 0,
+	.plate_released = EINA_FALSE,
+	.plate_out = NULL,
+	.plate_spare = NULL,
+	.transition = { 0, },
+	.transition_start = 0.0,
+	.paused = EINA_FALSE,
+	.resume_time = 0.0,
+
+	.plate_shown = 0.0,
+	.plate_render_armed = EINA_FALSE,
+	.mouse_down_time = 0.0,
+	.input_skew = 0.0,
+	.run_times = { 0, },
+
+	.dial_layout = DIAL_LAYOUT_10,
+	.sector_center = { { 0.0, }, },
+
+	.time_attack = EINA_FALSE,
+	.countdown = { 0, },
+	.countdown_tick = { 0, },
+	.countdown_deadline = 0.0,
+	.countdown_left = 0.0,
+	.countdown_seconds = 0,
+	.status_dirty = EINA_FALSE,
+	.time_attack_best = 0,
+
+	.idle_timer = { 0, },
+	.idle = EINA_FALSE,
+	.idle_activity = { 0, },
+
+	.stats_job = NULL,
+
+	.automation_head = 0,
+	.automation_tail = 0,
+	.automation_busy = EINA_FALSE,
+	.automation_job = NULL,
+	.automation_timer = { 0, },
+
+	.bench_count = 0,
+	.bench_total = 0,
+	.bench_start = 0.0,
+	.bench_rss_start = 0,
+
 	.mouse_down_dial_num = -1,
 	.level = 0,
-	.total_level = 20
+	.total_level = 20,
+	.best_score = 0,
+
+	.plate = 0,
+	.plate_next = -1,
+	.plate_count = 0,
+
+	.status = CATALOG_STR_COUNT,
+	.status_args = { 0, },
+
+	.select = NULL,
+	.select_itc = NULL,
+	.select_job = NULL,
+	.select_armed = EINA_FALSE,
+	.thumb_dir = { 0, },
+	.thumb_hash = { 0, },
 };
 
+/* Thumbnail of one realized cell, read from the disk cache or decoded and scaled in the background */
+typedef struct {
+	/* Image of the cell, NULL once the cell is unrealized */
+	Evas_Object *image;
+	Evas_Object *decoder;
+	Ecore_Thread *thread;
+	int plate;
+	int variant;
+	unsigned long long hash;
+	Eina_Bool hit;
+	/* Decoded plate, for the thread which scales it */
+	unsigned int *src;
+	int src_w;
+	int src_h;
+	int src_stride;
+	char plate_path[PATH_MAX];
+	unsigned int pixels[THUMB_SIZE * THUMB_SIZE];
+} view_thumb_s;
+
 static struct level_info {
 	int answer;
 	char *image;
-} level_data[100] = {
+	/* Score of tools/plate_calib, from 0 to SAMPLER_DIFFICULTY_MAX */
+	int difficulty;
+	/* Dial the plate is drawn for, every plate is on the classic one for now */
+	dial_layout_e layout;
+	/* Palette of an indexed plate, plates which differ only in colours share one file */
+	int variant;
+} level_data[VIEW_PLATE_MAX] = {
 		{
 				.answer = 0,
 				.image = "0"
 		},
 		{
 				.answer = 2,
-				.image = "lv1.png"
+				.image = "lv1.gip",
+				.difficulty = 4
 		},
 		{
 				.answer = 0,
-				.image = "lv2.png"
+				.image = "lv2.gip",
+				.difficulty = 6
 		},
 		{
 				.answer = 7,
-				.image = "lv3.png"
+				.image = "lv3.gip",
+				.difficulty = 5
 		},
 		{
 				.answer = 9,
-				.image = "lv4.png"
+				.image = "lv4.gip",
+				.difficulty = 10
 		},
 		{
 				.answer = 3,
-				.image = "lv5.png"
+				.image = "lv5.gip",
+				.difficulty = 14
 		},
 		{
 				.answer = 2,
-				.image = "lv6.png"
+				.image = "lv6.gip",
+				.difficulty = 17
 		},
 		{
 				.answer = 9,
-				.image = "lv7.png"
+				.image = "lv7.gip",
+				.difficulty = 12
 		},
 		{
 				.answer = 5,
-				.image = "lv8.png"
+				.image = "lv8.gip",
+				.difficulty = 19
 		},
 		{
 				.answer = 6,
-				.image = "lv9.png"
+				.image = "lv9.gip",
+				.difficulty = 15
 		},
 		{
 				.answer = 1,
-				.image = "lv10.png"
+				.image = "lv10.gip",
+				.difficulty = 16
 		},
 		{
 				.answer = 6,
-				.image = "lv11.png"
+				.image = "lv11.gip",
+				.difficulty = 16
 		},
 		{
 				.answer = 7,
-				.image = "lv12.png"
+				.image = "lv12.gip",
+				.difficulty = 17
 		},
 
 		{
 				.answer = 3,
-				.image = "lv13.png"
+				.image = "lv13.gip",
+				.difficulty = 25
 		},
 		{
 				.answer = 4,
-				.image = "lv14.png"
+				.image = "lv14.gip",
+				.difficulty = 19
 		},
 		{
 				.answer = 8,
-				.image = "lv15.png"
+				.image = "lv15.gip",
+				.difficulty = 28
 		},
 		{
 				.answer = 2,
-				.image = "lv16.png"
+				.image = "lv16.gip",
+				.difficulty = 27
 		},
 		{
 				.answer = 6,
-				.image = "lv17.png"
+				.image = "lv17.gip",
+				.difficulty = 33
 		},
 		{
 				.answer = 0,
-				.image = "lv18.png"
+				.image = "lv18.gip",
+				.difficulty = 35
 		},
 		{
 				.answer = 6,
-				.image = "lv19.png"
+				.image = "lv19.gip",
+				.difficulty = 42
 		},
 		{
-				.answer = 2,
-				.image = "lv20.png"
+				.answer = 1,
+				.image = "lv20.gip",
+				.difficulty = 53
 		},
 };
 
@@ -143,6 +388,19 @@ static void _rectangle_mouse_up_cb(void *data, Evas *e, Evas_Object *obj, void *
 static void _rectangle_mouse_move_cb(void *data, Evas *e, Evas_Object *obj, void *event_info);
 static void _dialer_text_resize(Evas_Object *entry);
 static void _dialer_layout_cb(void *data, Evas_Object *obj, void *event_info);
+static void _dialer_prefetch_plate(int plate);
+static void _first_render_post_cb(void *data, Evas *e, void *event_info);
+static double _input_time_get(unsigned int timestamp);
+static void _plate_render_post_cb(void *data, Evas *e, void *event_info);
+static void _time_attack_finish(int score);
+static void _dialer_frame_end_cb(void *data);
+static void _idle_arm(void);
+static void _bench_transition_done(void);
+static void _automation_kick(void);
+static void _automation_job_cb(void *data);
+static void _dialer_transition_commit(void);
+static void _dialer_show_level(int level, int plate);
+static void _level_select_close(void);
 
 /*
  * @brief Create Essential Object window, conformant and layout
@@ -163,10 +421,32 @@ void view_create(void)
 		return;
 	}
 
+	/* Time every main loop iteration and render from now on */
+	perf_watchdog_start(evas_object_evas_get(s_info.win));
+
+	/* Record when the first frame reaches the screen */
+	evas_event_callback_add(evas_object_evas_get(s_info.win), EVAS_CALLBACK_RENDER_POST, _first_render_post_cb, NULL);
+	evas_event_callback_add(evas_object_evas_get(s_info.win), EVAS_CALLBACK_RENDER_POST, _plate_render_post_cb, NULL);
+
+	/* Status text changed by timers is set once per frame */
+	tick_frame_end_cb_set(_dialer_frame_end_cb, NULL);
+
 	/* Show window after main view is set up */
 	evas_object_show(s_info.win);
 }
 
+/*
+ * @brief Function will be operated when the first frame is rendered
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] e The handle to an Evas canvas to be passed to the callback function
+ * @param[in] event_info The system event information
+ */
+static void _first_render_post_cb(void *data, Evas *e, void *event_info)
+{
+	evas_event_callback_del_full(e, EVAS_CALLBACK_RENDER_POST, _first_render_post_cb, data);
+	perf_mark(PERF_MARK_FIRST_RENDER);
+}
+
 /*
  * @brief Make a basic window named package
  * @param[in] pkg_name Name of the window
@@ -354,7 +634,15 @@ void view_destroy(void)
 		return;
 	}
 
+	tick_shutdown();
+	sampler_fini();
+	_level_select_close();
 	evas_object_del(s_info.win);
+
+	if (s_info.select_itc) {
+		elm_gengrid_item_class_free(s_info.select_itc);
+		s_info.select_itc = NULL;
+	}
 }
 
 /*
@@ -489,6 +777,78 @@ void view_set_button(Evas_Object *parent, const char *part_name, const char *sty
 	evas_object_show(btn);
 }
 
+/*
+ * @brief Use a dial layout for the hit test and calculate centre of each of its sectors
+ * @param[in] layout Dial layout of the plate
+ */
+static void _dialer_layout_set(dial_layout_e layout)
+{
+	int i;
+
+	s_info.dial_layout = layout;
+	for (i = 0; i < dial_layout_targets_get(layout); i++)
+		dial_layout_center_get(layout, i, &s_info.sector_center[i][0], &s_info.sector_center[i][1]);
+}
+
+/*
+ * @brief Index plates of level_data by difficulty, level 0 is the greeting and not a plate
+ */
+static void _dialer_sampler_init(void)
+{
+	unsigned char difficulty[sizeof(level_data) / sizeof(level_data[0])] = { 0, };
+	int count = 0;
+
+	while (count + 1 < (int)(sizeof(level_data) / sizeof(level_data[0])) && level_data[count + 1].image) {
+		difficulty[count] = (unsigned char)level_data[count + 1].difficulty;
+		count++;
+	}
+
+	if (sampler_init(difficulty, count, (unsigned int)time(NULL))) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to index %d plates.", count);
+		return;
+	}
+
+	s_info.plate_count = count;
+	s_info.plate_next = -1;
+}
+
+/*
+ * @brief Get the plate of the next level, picked once and kept until it is shown
+ * During a run it is picked for the skill after a right answer, a wrong answer ends the run
+ */
+static int _dialer_plate_next_get(void)
+{
+	double skill = sampler_skill_get();
+	int plate = -1;
+
+	if (s_info.plate_next > 0)
+		return s_info.plate_next;
+
+	if (s_info.level > 0)
+		skill = sampler_skill_update(skill, level_data[s_info.plate].difficulty, 1);
+
+	plate = sampler_pick(skill);
+	if (plate < 0)
+		return -1;
+
+	s_info.plate_next = plate + 1;
+
+	return s_info.plate_next;
+}
+
+/*
+ * @brief Update the skill with the answer of the plate on screen
+ * @param[in] right EINA_TRUE if the answer was right
+ */
+static void _dialer_answer(Eina_Bool right)
+{
+	sampler_answer(s_info.plate - 1, right);
+
+	/* Next plate was picked for a right answer */
+	if (!right)
+		s_info.plate_next = -1;
+}
+
 /*
  * @brief Make Rectangle Object to target window for hijacking touch event
  * @Add callback function will be operated when mouse down/up event is triggered
@@ -527,11 +887,19 @@ Evas_Object *view_dialer_create_rectangle()
 
 	evas_object_show(rect);
 
+	_dialer_layout_set(DIAL_LAYOUT_10);
+	_dialer_sampler_init();
+
 	/* Set callback for event about Rectangle */
 	evas_object_event_callback_add(rect, EVAS_CALLBACK_MOUSE_DOWN, _rectangle_mouse_down_cb, NULL);
 	evas_object_event_callback_add(rect, EVAS_CALLBACK_MOUSE_UP, _rectangle_mouse_up_cb, NULL);
 	evas_object_event_callback_add(rect, EVAS_CALLBACK_MOUSE_MOVE, _rectangle_mouse_move_cb, NULL);
 
+	_idle_arm();
+
+	/* Commands which came with the launch request wait for the touch layer */
+	_automation_kick();
+
 	return rect;
 }
 
@@ -553,6 +921,8 @@ void view_dialer_set_entry(const char *part_name)
 	}
 
 	s_info.entry = view_create_entry(s_info.layout, part_name, NULL, NULL);
+	/* view_create_entry() pushed the normal style */
+	s_info.entry_style = s_info.entry ? DIAL_TEXT_STYLE_NORMAL : NULL;
 }
 
 /*
@@ -624,18 +994,24 @@ int view_dialer_set_entry_text(int operation, const char *text)
 
 	} else if (operation == ENTRY_TEXT_BACKSPACE) {
 		const char* old_entry_text = elm_entry_entry_get(s_info.entry);
-
-		if (strlen(old_entry_text)) {
-			char *new_entry_text;
-			new_entry_text = strdup(old_entry_text);
-			if (new_entry_text) {
-				new_entry_text[strlen(old_entry_text) - 1] = '\0';
-				elm_entry_entry_set(s_info.entry, new_entry_text);
-				free(new_entry_text);
-			}
+		int old_length = strlen(old_entry_text);
+
+		if (old_length) {
+			/* Text is bounded by ENTRY_TEXT_MAX, no need for a heap copy */
+			char new_entry_text[ENTRY_TEXT_MAX + 1] = { 0, };
+			if (old_length > ENTRY_TEXT_MAX)
+				old_length = ENTRY_TEXT_MAX + 1;
+			memcpy(new_entry_text, old_entry_text, old_length - 1);
+			elm_entry_entry_set(s_info.entry, new_entry_text);
 		}
 	} else if (operation == ENTRY_TEXT_SHOW) {
-		elm_object_text_set(s_info.entry, text);
+		/*
+		 * Entry keeps its own copy, skip it when nothing changes.
+		 * The copy is the one allocation a tap makes, tests/view_replay_test.c budgets it
+		 */
+		const char *old_entry_text = elm_object_text_get(s_info.entry);
+		if (old_entry_text == NULL || text == NULL || strcmp(old_entry_text, text))
+			elm_object_text_set(s_info.entry, text);
 	} else {
 		dlog_print(DLOG_ERROR, LOG_TAG, "view_set_entry_text text operation is invalid!");
 		return -1;
@@ -647,69 +1023,16 @@ int view_dialer_set_entry_text(int operation, const char *text)
 }
 
 /*
- * @brief Get dial number of user's touch event position by calculating distance and slope from center
+ * @brief Get dial number of user's touch event position on the layout of the plate, see src/dial.c
  * @param[in] evt_x X-coordinate value of event position
  * @param[in] evt_y Y-coordinate value of event position
  */
 static int _get_btn_dial_number(int evt_x, int evt_y)
 {
-	int result = -1;
-
-	/* Calculation x and y from CENTER_REF point */
-	int x = evt_x - CENTER_REF_X;
-	int y = CENTER_REF_Y - evt_y;
-
-	/* Calculation the slope and radius from CENTER_REF point */
-	float slope = (float)y / (float)x;
-	float radius = sqrt(x*x + y*y);
-
-	if (radius > RADIUS_MIN) {
-		if (x == 0) {
-			if (y >= 0)
-				result = 0;
-			else
-				result = 5;
-		} else if (y == 0) {
-			if (x >= 0)
-				result = 2;
-			else
-				result = 8;
-		} else {
-			if (slope > SLOPE_72_DEGREE) {
-				if (y > 0)
-					result = 0;
-				else
-					result = 5;
-			} else if (slope > SLOPE_36_DEGREE) {
-				if (y > 0)
-					result = 1;
-				else
-					result = 6;
-			} else if (slope > SLOPE_180_DEGREE) {
-				if (y > 0)
-					result = 2;
-				else
-					result = 7;
-			} else if (slope > SLOPE_144_DEGREE) {
-				if (y > 0)
-					result = 8;
-				else
-					result = 3;
-			} else if (slope > SLOPE_108_DEGREE) {
-				if (y > 0)
-					result = 9;
-				else
-					result = 4;
-			} else {
-				if (y > 0)
-					result = 0;
-				else
-					result = 5;
-			}
-		}
-	} else {
+	int result = dial_layout_sector_get(s_info.dial_layout, evt_x, evt_y);
+
+	if (result == -1)
 		dlog_print(DLOG_DEBUG, LOG_TAG, "Ignore touch event under min radius");
-	}
 
 	return result;
 }
@@ -723,170 +1046,1893 @@ static int _get_btn_dial_number(int evt_x, int evt_y)
  */
 static void _rectangle_mouse_move_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
 {
-	Evas_Event_Mouse_Down *ev = (Evas_Event_Mouse_Down*) event_info;
+	Evas_Event_Mouse_Move *ev = (Evas_Event_Mouse_Move*) event_info;
+	double start = perf_cb_enter();
+
+	trace_recorder_add(TRACE_EVENT_MOVE, ev->cur.output.x, ev->cur.output.y, ev->timestamp);
 
 	/* Ignore unmatched touch event with mouse down event */
-	if (s_info.mouse_down_dial_num == -1)
+	if (s_info.mouse_down_dial_num == -1) {
+		perf_cb_leave(PERF_CB_MOUSE_MOVE, start);
 		return;
+	}
 
-	int temp_move_dial = _get_btn_dial_number(ev->output.x, ev->output.y);
+	int temp_move_dial = _get_btn_dial_number(ev->cur.output.x, ev->cur.output.y);
 
-	if (s_info.mouse_down_dial_num != temp_move_dial)
+	if (s_info.mouse_down_dial_num != temp_move_dial) {
 		s_info.mouse_down_dial_num = -1;
+		tick_timer_del(&s_info.longpress);
+	}
 
 	dlog_print(DLOG_DEBUG, LOG_TAG, "_mouse_move_cb is called down[%d]", s_info.mouse_down_dial_num);
+	perf_cb_leave(PERF_CB_MOUSE_MOVE, start);
 }
 
 /*
- * @brief Function will be operated when registered event is triggered
+ * @brief Function will be operated when the countdown display is due for the next second
  * @param[in] data The data to be passed to the callback function
  */
-static Eina_Bool _longpress_timer_cb(void *data)
+static void _countdown_tick_cb(void *data)
 {
-	char *new_dial = NULL;
+	double left = s_info.countdown_deadline - ecore_loop_time_get();
 
-	/* Clear Timer */
-	if (s_info.timer != NULL) {
-		dlog_print(DLOG_DEBUG, LOG_TAG, "Timer DELETE 0x%x - longpress", s_info.timer);
-		ecore_timer_del(s_info.timer);
-		s_info.timer = NULL;
+	/* Fired on the frame nearest to a whole second */
+	s_info.countdown_seconds = (int)lround(left);
+	s_info.status_dirty = EINA_TRUE;
+
+	if (s_info.countdown_seconds > 1)
+		tick_timer_add(&s_info.countdown_tick, left - (s_info.countdown_seconds - 1), _countdown_tick_cb, NULL);
+}
+
+/*
+ * @brief Function will be operated when the countdown of the plate runs out
+ * @param[in] data The data to be passed to the callback function
+ */
+static void _countdown_cb(void *data)
+{
+	/* Frames are rounded to the nearest one, never end the plate early.
+	 * A touch which started in time is judged by mouse up */
+	if (ecore_loop_time_get() < s_info.countdown_deadline
+			|| (s_info.mouse_down_dial_num != -1 && s_info.mouse_down_time <= s_info.countdown_deadline)) {
+		tick_timer_add(&s_info.countdown, 0.0, _countdown_cb, NULL);
+		return;
 	}
 
-	/* Ignore unmatched touch event with mouse down event */
-	if (s_info.mouse_down_dial_num == -1)
-		return EINA_FALSE;
-
-	if (s_info.mouse_down_dial_num == 3)
-		new_dial = strdup("#");
-	else if (s_info.mouse_down_dial_num == 5)
-		new_dial = strdup("+");
-	else if (s_info.mouse_down_dial_num == 7)
-		new_dial = strdup("*");
-	else
-		return ECORE_CALLBACK_CANCEL;
+	feedback_play(FEEDBACK_CUE_WRONG);
+	_dialer_answer(EINA_FALSE);
+	_time_attack_finish(s_info.level - 1);
+	data_progress_save(s_info.level, s_info.best_score);
+}
 
-	s_info.mouse_down_dial_num = -1;
+/*
+ * @brief Start the countdown of the plate on screen
+ * @param[in] time Time left for the plate in seconds
+ */
+static void _countdown_start(double time)
+{
+	double delay = 0.0;
 
-	if (new_dial) {
-		/* Set new Entry text for long-press */
-		view_dialer_set_entry_text(ENTRY_TEXT_ADD_TEXT, new_dial);
-		free(new_dial);
-	}
+	/* Deadline is on the clock of touch times, loop time lags behind within the iteration */
+	s_info.countdown_deadline = perf_time_get() + time;
+	s_info.countdown_seconds = (int)ceil(time);
+	s_info.status_dirty = EINA_TRUE;
 
-	return ECORE_CALLBACK_CANCEL;
+	delay = s_info.countdown_deadline - ecore_loop_time_get();
+	tick_timer_add(&s_info.countdown, delay, _countdown_cb, NULL);
+	if (s_info.countdown_seconds > 1)
+		tick_timer_add(&s_info.countdown_tick, delay - (s_info.countdown_seconds - 1), _countdown_tick_cb, NULL);
 }
 
 /*
- * @brief Function will be operated when mouse down event is triggered
+ * @brief Stop the countdown, e.g. when the plate is answered
+ */
+static void _countdown_stop(void)
+{
+	tick_timer_del(&s_info.countdown);
+	tick_timer_del(&s_info.countdown_tick);
+	s_info.countdown_deadline = 0.0;
+	s_info.countdown_seconds = 0;
+}
+
+/*
+ * @brief Function will be operated once after all timers of a frame have fired
+ * Timer callbacks only mark the status text dirty, it is set here at most once per frame
  * @param[in] data The data to be passed to the callback function
- * @param[in] e The handle to an Evas canvas to be passed to the callback function
- * @param[in] obj The Evas object handle to be passed to the callback function
- * @param[in] event_info The system event information
  */
-static void _rectangle_mouse_down_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
+static void _dialer_frame_end_cb(void *data)
 {
-	Evas_Event_Mouse_Down *ev = (Evas_Event_Mouse_Down*) event_info;
-	s_info.mouse_down_dial_num = _get_btn_dial_number(ev->output.x, ev->output.y);
-	dlog_print(DLOG_DEBUG, LOG_TAG, "%d", s_info.mouse_down_dial_num);
-	if (s_info.mouse_down_dial_num != -1) {
-		char signal[9] = {0, };
+	if (!s_info.status_dirty)
+		return;
+
+	s_info.status_dirty = EINA_FALSE;
+	if (!s_info.time_attack || s_info.level < 1)
+		return;
+
+	view_dialer_set_status(CATALOG_STR_LEVEL_TIME, s_info.level, s_info.countdown_seconds);
+}
+
+/*
+ * @brief Start a time attack run from the first level
+ */
+static void _time_attack_start(void)
+{
+	s_info.time_attack = EINA_TRUE;
+	s_info.countdown_left = 0.0;
+	memset(s_info.run_times, 0, sizeof(s_info.run_times));
+
+	/* Countdown starts once the plate is rendered */
+	view_dialer_set_level(1);
+}
+
+/*
+ * @brief End the time attack run and show its score
+ * @param[in] score Number of levels cleared in time
+ */
+static void _time_attack_finish(int score)
+{
+	_countdown_stop();
+	s_info.time_attack = EINA_FALSE;
+	s_info.countdown_left = 0.0;
+	s_info.level = 0;
+
+	if (s_info.time_attack_best < score)
+		s_info.time_attack_best = score;
 
-		/* Trigger touch animation */
-		snprintf(signal, sizeof(signal), "%s%d", "button.", s_info.mouse_down_dial_num);
-		elm_layout_signal_emit(s_info.layout, "button.dial.touch", signal);
-		dlog_print(DLOG_DEBUG, LOG_TAG, "%s", signal);
+	view_dialer_set_status(CATALOG_STR_TIME_SCORE, score, 0);
+}
+
+/*
+ * @brief Judge the answer of a time attack plate
+ * The touch time decides, not the frame in which the countdown timer fired
+ */
+static void _time_attack_judge(void)
+{
+	if ((s_info.countdown_deadline > 0.0 && s_info.mouse_down_time > s_info.countdown_deadline)
+			|| level_data[s_info.plate].answer != s_info.mouse_down_dial_num) {
+		feedback_play(FEEDBACK_CUE_WRONG);
+		_dialer_answer(EINA_FALSE);
+		_time_attack_finish(s_info.level - 1);
+	} else if (s_info.level >= s_info.total_level) {
+		feedback_play(FEEDBACK_CUE_RIGHT);
+		_dialer_answer(EINA_TRUE);
+		_time_attack_finish(s_info.level);
+	} else {
+		feedback_play(FEEDBACK_CUE_RIGHT);
+		_dialer_answer(EINA_TRUE);
+		view_dialer_set_level(s_info.level + 1);
 	}
 }
 
 /*
- * @brief Function will be operated when mouse up event is triggered
+ * @brief Function will be operated when the plate had no input for IDLE_TIME
+ * Scene is static until the next touch, nothing needs to animate or render
  * @param[in] data The data to be passed to the callback function
+ */
+static void _idle_enter_cb(void *data)
+{
+	/* Countdown and replay keep the scene moving */
+	if (s_info.time_attack || tick_timer_pending(&s_info.replay_timer) || s_info.mouse_down_dial_num != -1
+			|| (s_info.select && evas_object_visible_get(s_info.select))) {
+		tick_timer_add(&s_info.idle_timer, IDLE_TIME, _idle_enter_cb, NULL);
+		return;
+	}
+
+	if (s_info.idle || s_info.win == NULL)
+		return;
+
+	view_prewarm_cancel();
+	edje_object_play_set(elm_layout_edje_get(s_info.layout), EINA_FALSE);
+	ecore_evas_manual_render_set(ecore_evas_ecore_evas_get(evas_object_evas_get(s_info.win)), EINA_TRUE);
+
+	perf_activity_get(&s_info.idle_activity);
+	s_info.idle = EINA_TRUE;
+}
+
+/*
+ * @brief Leave idle mode, the next frame is rendered as usual
+ */
+static void _idle_leave(void)
+{
+	tick_timer_del(&s_info.idle_timer);
+
+	if (!s_info.idle)
+		return;
+
+	s_info.idle = EINA_FALSE;
+	ecore_evas_manual_render_set(ecore_evas_ecore_evas_get(evas_object_evas_get(s_info.win)), EINA_FALSE);
+	edje_object_play_set(elm_layout_edje_get(s_info.layout), EINA_TRUE);
+
+	perf_activity_report("idle", &s_info.idle_activity);
+}
+
+/*
+ * @brief Start counting IDLE_TIME from now
+ */
+static void _idle_arm(void)
+{
+	tick_timer_add(&s_info.idle_timer, IDLE_TIME, _idle_enter_cb, NULL);
+}
+
+/*
+ * @brief Free a thumbnail job
+ * @param[in] thumb Thumbnail job
+ */
+static void _thumb_free(view_thumb_s *thumb)
+{
+	free(thumb->src);
+	free(thumb);
+}
+
+/*
+ * @brief Show the thumbnail pixels in the cell
+ * @param[in] thumb Thumbnail job
+ */
+static void _thumb_show(view_thumb_s *thumb)
+{
+	evas_object_image_size_set(thumb->image, THUMB_SIZE, THUMB_SIZE);
+	evas_object_image_data_copy_set(thumb->image, thumb->pixels);
+	evas_object_image_data_update_add(thumb->image, 0, 0, THUMB_SIZE, THUMB_SIZE);
+}
+
+/*
+ * @brief Function will be operated when a thumbnail thread is cancelled, the cell is gone
+ * @param[in] data Thumbnail job
+ * @param[in] thread Thread of the job
+ */
+static void _thumb_cancel_cb(void *data, Ecore_Thread *thread)
+{
+	_thumb_free(data);
+}
+
+/*
+ * @brief Scale the decoded plate and write the thumbnail to the cache, in a worker thread
+ * @param[in] data Thumbnail job
+ * @param[in] thread Thread of the job
+ */
+static void _thumb_generate_thread_cb(void *data, Ecore_Thread *thread)
+{
+	view_thumb_s *thumb = data;
+	char path[PATH_MAX];
+
+	thumb_scale(thumb->src, thumb->src_w, thumb->src_h, thumb->src_stride, thumb->pixels);
+	free(thumb->src);
+	thumb->src = NULL;
+
+	thumb_cache_path(s_info.thumb_dir, thumb->hash, path, sizeof(path));
+	if (thumb_cache_save(path, thumb->hash, thumb->pixels))
+		dlog_print(DLOG_WARN, LOG_TAG, "failed to cache thumbnail %s", path);
+}
+
+/*
+ * @brief Function will be operated when the thumbnail is generated
+ * @param[in] data Thumbnail job
+ * @param[in] thread Thread of the job
+ */
+static void _thumb_generate_end_cb(void *data, Ecore_Thread *thread)
+{
+	view_thumb_s *thumb = data;
+
+	thumb->thread = NULL;
+	if (thumb->image == NULL) {
+		_thumb_free(thumb);
+		return;
+	}
+
+	_thumb_show(thumb);
+}
+
+/*
+ * @brief Function will be operated when the plate is decoded by the evas preload thread
+ * Pixels are copied out so the decoder and its cache entry can go right away
+ * @param[in] data Thumbnail job
  * @param[in] e The handle to an Evas canvas to be passed to the callback function
- * @param[in] obj The Evas object handle to be passed to the callback function
+ * @param[in] obj Decoder image object
  * @param[in] event_info The system event information
  */
-static void _rectangle_mouse_up_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
+static void _thumb_decoded_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
 {
-	dlog_print(DLOG_DEBUG, LOG_TAG, "%d", s_info.mouse_down_dial_num);
-	/* Clear Timer */
-	if (s_info.timer != NULL) {
-		dlog_print(DLOG_DEBUG, LOG_TAG, "Timer DELETE 0x%x - mouse up", s_info.timer);
-
-		ecore_timer_del(s_info.timer);
-		s_info.timer = NULL;
+	view_thumb_s *thumb = data;
+	unsigned int *pixels = NULL;
+	int w = 0;
+	int h = 0;
+	int stride;
+
+	evas_object_image_size_get(obj, &w, &h);
+	stride = evas_object_image_stride_get(obj) / (int)sizeof(*pixels);
+	pixels = evas_object_image_data_get(obj, EINA_FALSE);
+	if (pixels && w >= THUMB_SIZE && h >= THUMB_SIZE && stride >= w) {
+		thumb->src = malloc((size_t)stride * h * sizeof(*pixels));
+		if (thumb->src) {
+			memcpy(thumb->src, pixels, (size_t)stride * h * sizeof(*pixels));
+			thumb->src_w = w;
+			thumb->src_h = h;
+			thumb->src_stride = stride;
+		}
 	}
+	if (pixels)
+		evas_object_image_data_set(obj, pixels);
 
-	/* Ignore unmatched touch event with mouse down event */
-	if (s_info.mouse_down_dial_num == -1)
+	thumb->decoder = NULL;
+	evas_object_del(obj);
+
+	if (thumb->src == NULL) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to decode plate %s", thumb->plate_path);
 		return;
+	}
 
-	/* Set new Entry text */
-	char new_dial[2] = { 0, };
-	snprintf(new_dial, sizeof(new_dial), "%d", s_info.mouse_down_dial_num);
-	//view_dialer_set_entry_text(ENTRY_TEXT_ADD_TEXT, new_dial);
-	dlog_print(DLOG_DEBUG, LOG_TAG, "%s", new_dial);
+	thumb->thread = ecore_thread_run(_thumb_generate_thread_cb, _thumb_generate_end_cb, _thumb_cancel_cb, thumb);
+}
+
+/*
+ * @brief Expand an indexed plate and scale it to the thumbnail, in a worker thread
+ * @param[in] thumb Thumbnail job
+ */
+static int _thumb_expand(view_thumb_s *thumb)
+{
+	plate_s plate;
+	int w, h;
+	int ret = -1;
 
+	if (plate_open(&plate, thumb->plate_path))
+		return -1;
 
-	if(s_info.level == 0 || level_data[s_info.level].answer == s_info.mouse_down_dial_num) {
-		s_info.level ++;
-		if(s_info.total_level < s_info.level) {
-			view_dialer_set_entry_text(ENTRY_TEXT_SHOW, "Good Eye!");
-			s_info.level = 0;
-		} else {
-			char *image = level_data[s_info.level].image;
-			view_set_image(view_dialer_get_layout_object(), "sw.button.bg", data_get_level_full_image_path(image));
-			char levels[100] = { 0 };
-			snprintf(levels, sizeof(levels), "Level %d", s_info.level);
-			view_dialer_set_entry_text(ENTRY_TEXT_SHOW, levels);
+	w = plate.header->width;
+	h = plate.header->height;
+	if (w >= THUMB_SIZE && h >= THUMB_SIZE) {
+		thumb->src = malloc((size_t)w * h * sizeof(*thumb->src));
+		if (thumb->src && !plate_expand(&plate, thumb->variant, thumb->src, w)) {
+			thumb_scale(thumb->src, w, h, w, thumb->pixels);
+			ret = 0;
 		}
+		free(thumb->src);
+		thumb->src = NULL;
+	}
+	plate_close(&plate);
 
-	} else {
-		char levels[100] = { 0 };
-		snprintf(levels, sizeof(levels), "Your Score: %d", s_info.level);
-		view_dialer_set_entry_text(ENTRY_TEXT_SHOW, levels);
-		s_info.level = 0;
+	return ret;
+}
+
+/*
+ * @brief Hash the plate file and read its thumbnail from the cache, in a worker thread
+ * Indexed plates expand about as fast as a thumbnail is read, they skip the cache
+ * @param[in] data Thumbnail job
+ * @param[in] thread Thread of the job
+ */
+static void _thumb_load_thread_cb(void *data, Ecore_Thread *thread)
+{
+	view_thumb_s *thumb = data;
+	char path[PATH_MAX];
+
+	if (plate_path_is_indexed(thumb->plate_path)) {
+		thumb->hit = !_thumb_expand(thumb);
+		return;
 	}
-	_dialer_text_resize(s_info.entry);
-	/* Initialize event records */
-	s_info.mouse_down_dial_num = -1;
+
+	if (thumb->hash == 0)
+		thumb->hash = thumb_file_hash(thumb->plate_path);
+	if (thumb->hash == 0 || ecore_thread_check(thread))
+		return;
+
+	thumb_cache_path(s_info.thumb_dir, thumb->hash, path, sizeof(path));
+	thumb->hit = !thumb_cache_load(path, thumb->hash, thumb->pixels);
 }
 
 /*
- * @brief Layout back key event callback function
- * @param[in] data The data to be passed to the callback function
- * @param[in] obj The Evas object handle to be passed to the callback function
- * @param[in] event_info The system event information
+ * @brief Function will be operated when the cache lookup is done
+ * On a miss the plate is decoded at reduced size by the evas preload thread
+ * @param[in] data Thumbnail job
+ * @param[in] thread Thread of the job
  */
-static void _dialer_layout_cb(void *data, Evas_Object *obj, void *event_info)
+static void _thumb_load_end_cb(void *data, Ecore_Thread *thread)
 {
-	dlog_print(DLOG_DEBUG, LOG_TAG, "_dialer_layout_cb is called");
-	ui_app_exit();
+	view_thumb_s *thumb = data;
+
+	thumb->thread = NULL;
+	if (thumb->image == NULL) {
+		_thumb_free(thumb);
+		return;
+	}
+
+	/* Indexed plates are never hashed */
+	if (thumb->hash)
+		s_info.thumb_hash[thumb->plate] = thumb->hash;
+
+	if (thumb->hit) {
+		_thumb_show(thumb);
+		return;
+	}
+
+	if (thumb->hash == 0) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to read plate %s", thumb->plate_path);
+		return;
+	}
+
+	thumb->decoder = evas_object_image_add(evas_object_evas_get(thumb->image));
+	evas_object_image_load_size_set(thumb->decoder, THUMB_SIZE, THUMB_SIZE);
+	evas_object_image_file_set(thumb->decoder, thumb->plate_path, NULL);
+	evas_object_event_callback_add(thumb->decoder, EVAS_CALLBACK_IMAGE_PRELOADED, _thumb_decoded_cb, thumb);
+	evas_object_image_preload(thumb->decoder, EINA_FALSE);
 }
 
 /*
- * @brief Resize dialer entry text for long text
- * @param[in] entry Entry object to be modified by this function
+ * @brief Function will be operated when the image of a cell is deleted, the job stops where it is
+ * @param[in] data Thumbnail job
+ * @param[in] e The handle to an Evas canvas to be passed to the callback function
+ * @param[in] obj Image of the cell
+ * @param[in] event_info The system event information
  */
-static void _dialer_text_resize(Evas_Object *entry)
+static void _thumb_del_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
 {
-	const char *dial_entry = elm_entry_entry_get(entry);
-	int text_length = strlen(dial_entry);
+	view_thumb_s *thumb = data;
 
-	/* Change Entry text style and size according to length */
-	if (text_length < 10)
-		elm_entry_text_style_user_push(entry, DIAL_TEXT_STYLE_NORMAL);
-	else if (text_length < 15)
-		elm_entry_text_style_user_push(entry, DIAL_TEXT_STYLE_SMALL);
-	else
-		elm_entry_text_style_user_push(entry, DIAL_TEXT_STYLE_SMALLER);
-	/* Set entry cursor to end for displaying last updated entry text*/
-	elm_entry_cursor_end_set(entry);
+	thumb->image = NULL;
+
+	/* Freed by the end or cancel callback of the thread */
+	if (thumb->thread) {
+		ecore_thread_cancel(thumb->thread);
+		return;
+	}
+
+	if (thumb->decoder)
+		evas_object_del(thumb->decoder);
+	_thumb_free(thumb);
 }
 
 /*
- * @brief This function just return static layout object.
+ * @brief Get the level number of a level select cell
+ * @param[in] data Plate of the cell
+ * @param[in] obj Level select gengrid
+ * @param[in] part Text part of the item style
  */
-Evas_Object *view_dialer_get_layout_object(void)
+static char *_level_select_text_get(void *data, Evas_Object *obj, const char *part)
 {
-	return s_info.layout;
+	char text[VIEW_STATUS_MAX];
+
+	if (strcmp(part, "elm.text"))
+		return NULL;
+
+	snprintf(text, sizeof(text), "%d", (int)(intptr_t)data);
+
+	return strdup(text);
+}
+
+/*
+ * @brief Create the thumbnail of a level select cell when the cell is realized
+ * The image stays empty until its thumbnail is ready, nothing blocks the frame
+ * @param[in] data Plate of the cell
+ * @param[in] obj Level select gengrid
+ * @param[in] part Content part of the item style
+ */
+static Evas_Object *_level_select_content_get(void *data, Evas_Object *obj, const char *part)
+{
+	view_thumb_s *thumb = NULL;
+	int plate = (int)(intptr_t)data;
+
+	if (strcmp(part, "elm.swallow.icon"))
+		return NULL;
+
+	thumb = calloc(1, sizeof(*thumb));
+	if (thumb == NULL) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to allocate a thumbnail");
+		return NULL;
+	}
+
+	thumb->plate = plate;
+	thumb->hash = s_info.thumb_hash[plate];
+	thumb->variant = level_data[plate].variant;
+	data_get_level_image_path(level_data[plate].image, thumb->plate_path, (int)sizeof(thumb->plate_path));
+
+	thumb->image = evas_object_image_filled_add(evas_object_evas_get(obj));
+	evas_object_image_alpha_set(thumb->image, EINA_TRUE);
+	evas_object_size_hint_min_set(thumb->image, THUMB_SIZE, THUMB_SIZE);
+	evas_object_size_hint_aspect_set(thumb->image, EVAS_ASPECT_CONTROL_BOTH, 1, 1);
+	evas_object_event_callback_add(thumb->image, EVAS_CALLBACK_DEL, _thumb_del_cb, thumb);
+
+	thumb->thread = ecore_thread_run(_thumb_load_thread_cb, _thumb_load_end_cb, _thumb_cancel_cb, thumb);
+
+	return thumb->image;
+}
+
+/*
+ * @brief Close the level select, its cells and thumbnails are freed
+ */
+static void _level_select_close(void)
+{
+	if (s_info.select_job) {
+		ecore_job_del(s_info.select_job);
+		s_info.select_job = NULL;
+	}
+
+	if (s_info.select == NULL || !evas_object_visible_get(s_info.select))
+		return;
+
+	evas_object_hide(s_info.select);
+	elm_gengrid_clear(s_info.select);
+	_idle_arm();
+}
+
+/*
+ * @brief Start the run from the picked level, out of the select callback of the gengrid
+ * @param[in] data Plate of the picked cell
+ */
+static void _level_select_pick_job_cb(void *data)
+{
+	int plate = (int)(intptr_t)data;
+
+	s_info.select_job = NULL;
+	_level_select_close();
+
+	memset(s_info.run_times, 0, sizeof(s_info.run_times));
+	_dialer_show_level(plate, plate);
+}
+
+/*
+ * @brief Function will be operated when a level select cell is clicked
+ * @param[in] data Plate of the cell
+ * @param[in] obj Level select gengrid
+ * @param[in] event_info Gengrid item
+ */
+static void _level_select_item_cb(void *data, Evas_Object *obj, void *event_info)
+{
+	if (s_info.select_job)
+		return;
+
+	/* Items must not be cleared inside their own callback */
+	s_info.select_job = ecore_job_add(_level_select_pick_job_cb, data);
+}
+
+/*
+ * @brief Function will be operated when back key is pressed on the level select
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] obj Level select gengrid
+ * @param[in] event_info The system event information
+ */
+static void _level_select_back_cb(void *data, Evas_Object *obj, void *event_info)
+{
+	_level_select_close();
+}
+
+/*
+ * @brief Create the level select gengrid on top of the touch layer
+ */
+static Evas_Object *_level_select_create(void)
+{
+	Evas_Object *grid = NULL;
+
+	data_get_data_path(THUMB_DIR, s_info.thumb_dir, (int)sizeof(s_info.thumb_dir));
+	if (mkdir(s_info.thumb_dir, 0700) && errno != EEXIST)
+		dlog_print(DLOG_WARN, LOG_TAG, "failed to create %s, thumbnails are not cached", s_info.thumb_dir);
+
+	s_info.select_itc = elm_gengrid_item_class_new();
+	if (s_info.select_itc == NULL) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to create a gengrid item class");
+		return NULL;
+	}
+	s_info.select_itc->item_style = "default";
+	s_info.select_itc->func.text_get = _level_select_text_get;
+	s_info.select_itc->func.content_get = _level_select_content_get;
+	s_info.select_itc->func.state_get = NULL;
+	s_info.select_itc->func.del = NULL;
+
+	grid = elm_gengrid_add(s_info.win);
+	if (grid == NULL) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to create a gengrid");
+		return NULL;
+	}
+
+	elm_gengrid_item_size_set(grid, VIEW_SELECT_CELL_SIZE, VIEW_SELECT_CELL_SIZE);
+	elm_gengrid_align_set(grid, 0.5, 0.0);
+	elm_gengrid_select_mode_set(grid, ELM_OBJECT_SELECT_MODE_ALWAYS);
+	evas_object_size_hint_weight_set(grid, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+	elm_win_resize_object_add(s_info.win, grid);
+	eext_object_event_callback_add(grid, EEXT_CALLBACK_BACK, _level_select_back_cb, NULL);
+
+	return grid;
+}
+
+/*
+ * @brief Open the level select with every unlocked level, one past the best score
+ */
+static void _level_select_open(void)
+{
+	int unlocked = s_info.best_score + 1;
+	int i;
+
+	if (s_info.select == NULL) {
+		s_info.select = _level_select_create();
+		if (s_info.select == NULL)
+			return;
+	}
+
+	if (unlocked > s_info.total_level)
+		unlocked = s_info.total_level;
+	if (unlocked > s_info.plate_count)
+		unlocked = s_info.plate_count;
+
+	elm_gengrid_clear(s_info.select);
+	for (i = 1; i <= unlocked; i++)
+		elm_gengrid_item_append(s_info.select, s_info.select_itc, (void *)(intptr_t)i, _level_select_item_cb, (void *)(intptr_t)i);
+
+	_idle_leave();
+	view_prewarm_cancel();
+
+	evas_object_raise(s_info.select);
+	evas_object_show(s_info.select);
+}
+
+/*
+ * @brief Function will be operated when the touch is held for LONGPRESS_TIME
+ * Long press on the greeting starts a time attack run
+ * @param[in] data The data to be passed to the callback function
+ */
+static void _longpress_cb(void *data)
+{
+	double start = perf_cb_enter();
+
+	/* Ignore unmatched touch event with mouse down event */
+	if (s_info.mouse_down_dial_num == -1 || s_info.level != 0) {
+		perf_cb_leave(PERF_CB_LONGPRESS, start);
+		return;
+	}
+
+	/* Touch is consumed, mouse up must not answer the first plate */
+	s_info.mouse_down_dial_num = -1;
+	_time_attack_start();
+
+	perf_cb_leave(PERF_CB_LONGPRESS, start);
+}
+
+/*
+ * @brief Function will be operated when mouse down event is triggered
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] e The handle to an Evas canvas to be passed to the callback function
+ * @param[in] obj The Evas object handle to be passed to the callback function
+ * @param[in] event_info The system event information
+ */
+static void _rectangle_mouse_down_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
+{
+	Evas_Event_Mouse_Down *ev = (Evas_Event_Mouse_Down*) event_info;
+	double start = perf_cb_enter();
+
+	trace_recorder_add(TRACE_EVENT_DOWN, ev->output.x, ev->output.y, ev->timestamp);
+	s_info.mouse_down_time = _input_time_get(ev->timestamp);
+
+	/* A tap never waits for the transition, the new plate is shown as it is */
+	_dialer_transition_commit();
+
+	/* Rendering is back on the next frame */
+	_idle_leave();
+
+	/* User is here, idle time is over */
+	view_prewarm_cancel();
+
+	s_info.mouse_down_dial_num = _get_btn_dial_number(ev->output.x, ev->output.y);
+	dlog_print(DLOG_DEBUG, LOG_TAG, "%d", s_info.mouse_down_dial_num);
+
+	/* Tap in the centre of the greeting opens the level select */
+	s_info.select_armed = s_info.mouse_down_dial_num == -1 && s_info.level == 0 && !s_info.time_attack;
+
+	if (s_info.mouse_down_dial_num != -1) {
+		/* Move the shared feedback image to the sector and trigger touch animation */
+		edje_object_part_drag_value_set(elm_layout_edje_get(s_info.layout), "sw.touch.anchor",
+				s_info.sector_center[s_info.mouse_down_dial_num][0], s_info.sector_center[s_info.mouse_down_dial_num][1]);
+		elm_layout_signal_emit(s_info.layout, "button.dial.touch", "sw.touch.feedback");
+		feedback_play(FEEDBACK_CUE_TAP);
+
+		if (s_info.level == 0)
+			tick_timer_add(&s_info.longpress, LONGPRESS_TIME, _longpress_cb, NULL);
+	}
+
+	perf_cb_leave(PERF_CB_MOUSE_DOWN, start);
+}
+
+/*
+ * @brief Add the finished run to the leaderboard and start a new one
+ * @param[in] score Score of the run
+ */
+static void _dialer_run_finish(int score)
+{
+	data_stats_add_run(score, s_info.run_times, s_info.total_level + 1);
+	memset(s_info.run_times, 0, sizeof(s_info.run_times));
+}
+
+/*
+ * @brief Function will be operated when mouse up event is triggered
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] e The handle to an Evas canvas to be passed to the callback function
+ * @param[in] obj The Evas object handle to be passed to the callback function
+ * @param[in] event_info The system event information
+ */
+static void _rectangle_mouse_up_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
+{
+	Evas_Event_Mouse_Up *ev = (Evas_Event_Mouse_Up*) event_info;
+	double start = perf_cb_enter();
+
+	trace_recorder_add(TRACE_EVENT_UP, ev->output.x, ev->output.y, ev->timestamp);
+	_idle_arm();
+
+	dlog_print(DLOG_DEBUG, LOG_TAG, "%d", s_info.mouse_down_dial_num);
+	/* Clear Timer */
+	tick_timer_del(&s_info.longpress);
+
+	if (s_info.select_armed) {
+		s_info.select_armed = EINA_FALSE;
+		if (s_info.level == 0 && dial_layout_sector_get(s_info.dial_layout, ev->output.x, ev->output.y) == -1)
+			_level_select_open();
+	}
+
+	/* Ignore unmatched touch event with mouse down event */
+	if (s_info.mouse_down_dial_num == -1) {
+		perf_cb_leave(PERF_CB_MOUSE_UP, start);
+		return;
+	}
+
+	/* Set new Entry text */
+	char new_dial[2] = { 0, };
+	snprintf(new_dial, sizeof(new_dial), "%d", s_info.mouse_down_dial_num);
+	//view_dialer_set_entry_text(ENTRY_TEXT_ADD_TEXT, new_dial);
+	dlog_print(DLOG_DEBUG, LOG_TAG, "%s", new_dial);
+
+
+	if (s_info.level > 0 && s_info.plate_shown > 0.0 && s_info.mouse_down_time > s_info.plate_shown) {
+		reaction_sample_s sample = {
+			.reaction_us = (unsigned int)((s_info.mouse_down_time - s_info.plate_shown) * 1000000.0),
+			.level = (unsigned char)s_info.level,
+			.answer = (unsigned char)level_data[s_info.plate].answer,
+			.tapped = (signed char)s_info.mouse_down_dial_num,
+		};
+		reaction_push(&sample);
+		s_info.run_times[s_info.level] = sample.reaction_us / 1000;
+	}
+
+	if (s_info.time_attack) {
+		_time_attack_judge();
+	} else if(s_info.level == 0 || level_data[s_info.plate].answer == s_info.mouse_down_dial_num) {
+		if (s_info.level > 0) {
+			feedback_play(FEEDBACK_CUE_RIGHT);
+			_dialer_answer(EINA_TRUE);
+		}
+		if(s_info.total_level < s_info.level + 1) {
+			view_dialer_set_status(CATALOG_STR_CLEAR, 0, 0);
+			if (s_info.best_score < s_info.total_level)
+				s_info.best_score = s_info.total_level;
+			_dialer_run_finish(s_info.total_level);
+			s_info.level = 0;
+		} else {
+			view_dialer_set_level(s_info.level + 1);
+		}
+
+	} else {
+		feedback_play(FEEDBACK_CUE_WRONG);
+		_dialer_answer(EINA_FALSE);
+		view_dialer_set_status(CATALOG_STR_SCORE, s_info.level, 0);
+		if (s_info.best_score < s_info.level)
+			s_info.best_score = s_info.level;
+		_dialer_run_finish(s_info.level);
+		s_info.level = 0;
+	}
+	_dialer_text_resize(s_info.entry);
+
+	/* Written by the data module in the background, a time attack run is not resumed */
+	data_progress_save(s_info.time_attack ? 0 : s_info.level, s_info.best_score);
+	/* Initialize event records */
+	s_info.mouse_down_dial_num = -1;
+
+	perf_cb_leave(PERF_CB_MOUSE_UP, start);
+}
+
+/*
+ * @brief Layout back key event callback function
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] obj The Evas object handle to be passed to the callback function
+ * @param[in] event_info The system event information
+ */
+static void _dialer_layout_cb(void *data, Evas_Object *obj, void *event_info)
+{
+	dlog_print(DLOG_DEBUG, LOG_TAG, "_dialer_layout_cb is called");
+	ui_app_exit();
+}
+
+/*
+ * @brief Resize dialer entry text for long text
+ * @param[in] entry Entry object to be modified by this function
+ */
+static void _dialer_text_resize(Evas_Object *entry)
+{
+	double start = perf_cb_enter();
+	const char *dial_entry = elm_entry_entry_get(entry);
+	int text_length = strlen(dial_entry);
+	const char *style = NULL;
+
+	/* Change Entry text style and size according to length */
+	if (text_length < 10)
+		style = DIAL_TEXT_STYLE_NORMAL;
+	else if (text_length < 15)
+		style = DIAL_TEXT_STYLE_SMALL;
+	else
+		style = DIAL_TEXT_STYLE_SMALLER;
+
+	/* Every push allocates and stacks a style, replace it only when the size changes */
+	if (style != s_info.entry_style) {
+		if (s_info.entry_style)
+			elm_entry_text_style_user_pop(entry);
+		elm_entry_text_style_user_push(entry, style);
+		s_info.entry_style = style;
+	}
+	/* Set entry cursor to end for displaying last updated entry text*/
+	elm_entry_cursor_end_set(entry);
+
+	perf_cb_leave(PERF_CB_TEXT_RESIZE, start);
+}
+
+/*
+ * @brief This function just return static layout object.
+ */
+Evas_Object *view_dialer_get_layout_object(void)
+{
+	return s_info.layout;
+}
+
+/*
+ * @brief Function will be operated when the frame with a new plate is rendered
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] e The handle to an Evas canvas to be passed to the callback function
+ * @param[in] event_info The system event information
+ */
+static void _plate_render_post_cb(void *data, Evas *e, void *event_info)
+{
+	/* Stays registered, adding a callback per plate would allocate on the tap path */
+	if (!s_info.plate_render_armed)
+		return;
+
+	s_info.plate_render_armed = EINA_FALSE;
+	s_info.plate_shown = perf_time_get();
+
+	/* Countdown is fair only from the frame the player can see, time left before pause is kept */
+	if (s_info.time_attack && s_info.level > 0) {
+		_countdown_start(s_info.countdown_left > 0.0 ? s_info.countdown_left : TIME_ATTACK_PLATE_TIME);
+		s_info.countdown_left = 0.0;
+	}
+
+	if (s_info.bench_start > 0.0)
+		_bench_transition_done();
+}
+
+/*
+ * @brief Convert evas event timestamp to the monotonic clock of perf_time_get()
+ * Input timestamps run on their own clock, the smallest observed difference is taken as offset
+ * @param[in] timestamp Event timestamp in ms
+ */
+static double _input_time_get(unsigned int timestamp)
+{
+	double skew = perf_time_get() - timestamp / 1000.0;
+
+	if (s_info.input_skew == 0.0 || skew < s_info.input_skew)
+		s_info.input_skew = skew;
+
+	return timestamp / 1000.0 + s_info.input_skew;
+}
+
+/*
+ * @brief Get the image object of "sw.button.bg" for a plate
+ * The two plate objects take turns in "sw.button.bg" and "sw.button.bg.out", one is made only
+ * when the kind of the plate changes, e.g. from the greeting to the first level, or after a release
+ * @param[in] indexed EINA_TRUE for an evas image of an indexed plate, EINA_FALSE for an elm_image
+ * @return The image object swallowed in "sw.button.bg"
+ */
+static Evas_Object *_dialer_plate_object_get(Eina_Bool indexed)
+{
+	Evas_Object *image = NULL;
+
+	image = elm_object_part_content_unset(s_info.layout, "sw.button.bg");
+	if (image == NULL) {
+		image = s_info.plate_spare;
+		s_info.plate_spare = NULL;
+	}
+
+	if (image && (evas_object_data_get(image, VIEW_PLATE_INDEXED_KEY) != NULL) != indexed) {
+		evas_object_del(image);
+		image = NULL;
+	}
+
+	if (image == NULL && indexed) {
+		image = evas_object_image_filled_add(evas_object_evas_get(s_info.layout));
+		if (image) {
+			evas_object_data_set(image, VIEW_PLATE_INDEXED_KEY, image);
+			evas_object_image_alpha_set(image, EINA_TRUE);
+		}
+	} else if (image == NULL) {
+		image = elm_image_add(s_info.layout);
+	}
+
+	if (image == NULL) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to create an image object.");
+		return NULL;
+	}
+
+	elm_object_part_content_set(s_info.layout, "sw.button.bg", image);
+	evas_object_show(image);
+
+	return image;
+}
+
+/*
+ * @brief Expand an indexed plate straight into the image data of "sw.button.bg"
+ * The image data of the same size is written in place, nothing is allocated from level to level
+ * @param[in] path Path of the indexed plate
+ * @param[in] variant Palette of the plate
+ */
+static void _dialer_set_indexed_plate(const char *path, int variant)
+{
+	Evas_Object *image = NULL;
+	unsigned int *pixels = NULL;
+	plate_s plate;
+	int stride;
+
+	if (s_info.prefetch_plate.map && !strcmp(s_info.prefetch_path, path)) {
+		plate = s_info.prefetch_plate;
+		memset(&s_info.prefetch_plate, 0, sizeof(s_info.prefetch_plate));
+	} else if (plate_open(&plate, path)) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to open plate %s", path);
+		return;
+	}
+
+	image = _dialer_plate_object_get(EINA_TRUE);
+	if (image == NULL) {
+		plate_close(&plate);
+		return;
+	}
+
+	evas_object_image_size_set(image, plate.header->width, plate.header->height);
+	pixels = evas_object_image_data_get(image, EINA_TRUE);
+	stride = evas_object_image_stride_get(image) / (int)sizeof(*pixels);
+	if (pixels == NULL || plate_expand(&plate, variant, pixels, stride))
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to expand plate %s variant %d", path, variant);
+	if (pixels)
+		evas_object_image_data_set(image, pixels);
+	evas_object_image_data_update_add(image, 0, 0, plate.header->width, plate.header->height);
+
+	plate_close(&plate);
+}
+
+/*
+ * @brief Set the plate image to "sw.button.bg" part and remember it for restoring after release
+ * @param[in] image_path Path of the plate image file, or of an indexed plate
+ */
+void view_dialer_set_plate(const char *image_path)
+{
+	if (image_path == NULL) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "image path is NULL.");
+		return;
+	}
+
+	/* Palette is set along with the path by _dialer_show_level() */
+	if (image_path != s_info.plate_path) {
+		snprintf(s_info.plate_path, sizeof(s_info.plate_path), "%s", image_path);
+		s_info.plate_variant = 0;
+	}
+
+	if (plate_path_is_indexed(s_info.plate_path)) {
+		_dialer_set_indexed_plate(s_info.plate_path, s_info.plate_variant);
+	} else if (_dialer_plate_object_get(EINA_FALSE)) {
+		view_set_image(s_info.layout, "sw.button.bg", s_info.plate_path);
+	}
+	s_info.plate_released = EINA_FALSE;
+
+	/* Reaction time counts from the frame which shows the plate */
+	s_info.plate_shown = 0.0;
+	s_info.plate_render_armed = EINA_TRUE;
+}
+
+/*
+ * @brief End the level transition, the plate of the previous level is kept aside for the next level
+ */
+static void _dialer_transition_commit(void)
+{
+	tick_timer_del(&s_info.transition);
+
+	if (s_info.plate_out == NULL)
+		return;
+
+	elm_object_part_content_unset(s_info.layout, "sw.button.bg.out");
+	evas_object_hide(s_info.plate_out);
+	evas_object_color_set(s_info.plate_out, 255, 255, 255, 255);
+
+	if (s_info.plate_spare)
+		evas_object_del(s_info.plate_spare);
+	s_info.plate_spare = s_info.plate_out;
+	s_info.plate_out = NULL;
+}
+
+/*
+ * @brief Function will be operated on every frame of the level transition
+ * Only the alpha of the decoded plate changes, nothing is loaded or scaled
+ * @param[in] data The data to be passed to the callback function
+ */
+static void _dialer_transition_cb(void *data)
+{
+	double pos = (perf_time_get() - s_info.transition_start) / VIEW_TRANSITION_TIME;
+	int alpha;
+
+	if (pos >= 1.0) {
+		_dialer_transition_commit();
+		return;
+	}
+
+	/* Colours are premultiplied */
+	alpha = (int)(255 * (1.0 - ecore_animator_pos_map(pos, ECORE_POS_MAP_DECELERATE, 0.0, 0.0)));
+	evas_object_color_set(s_info.plate_out, alpha, alpha, alpha, alpha);
+
+	tick_timer_add(&s_info.transition, 0.0, _dialer_transition_cb, NULL);
+}
+
+/*
+ * @brief Move the plate on screen over the next one, it fades out once the next plate is set
+ */
+static void _dialer_transition_begin(void)
+{
+	Evas_Object *image = NULL;
+
+	_dialer_transition_commit();
+
+	if (VIEW_TRANSITION_TIME <= 0.0 || s_info.layout == NULL || s_info.plate_released || s_info.paused)
+		return;
+
+	image = elm_object_part_content_unset(s_info.layout, "sw.button.bg");
+	if (image == NULL)
+		return;
+
+	/* Next plate is set to the spare image object, the previous decode stays untouched */
+	elm_object_part_content_set(s_info.layout, "sw.button.bg.out", image);
+	s_info.plate_out = image;
+	s_info.transition_start = perf_time_get();
+	tick_timer_add(&s_info.transition, 0.0, _dialer_transition_cb, NULL);
+}
+
+/*
+ * @brief Drop the prefetched plate and flush evas and edje caches
+ */
+static void _dialer_flush_caches(void)
+{
+	Evas *evas = NULL;
+
+	tick_timer_del(&s_info.prefetch_timer);
+
+	if (s_info.prefetch) {
+		evas_object_del(s_info.prefetch);
+		s_info.prefetch = NULL;
+	}
+	plate_close(&s_info.prefetch_plate);
+
+	if (s_info.win == NULL)
+		return;
+
+	evas = evas_object_evas_get(s_info.win);
+	evas_image_cache_flush(evas);
+	evas_font_cache_flush(evas);
+	evas_render_idle_flush(evas);
+
+	edje_file_cache_flush();
+	edje_collection_cache_flush();
+}
+
+/*
+ * @brief Release decoded plate buffers and caches while the application is invisible
+ */
+void view_dialer_release_resources(void)
+{
+	Evas_Object *image = NULL;
+	int rss_before = data_get_rss_kb();
+
+	view_prewarm_cancel();
+	_dialer_transition_commit();
+	_level_select_close();
+
+	if (s_info.restore_job) {
+		ecore_job_del(s_info.restore_job);
+		s_info.restore_job = NULL;
+	}
+
+	if (s_info.layout && !s_info.plate_released) {
+		image = elm_object_part_content_unset(s_info.layout, "sw.button.bg");
+		if (image)
+			evas_object_del(image);
+		s_info.plate_released = EINA_TRUE;
+	}
+
+	if (s_info.plate_spare) {
+		evas_object_del(s_info.plate_spare);
+		s_info.plate_spare = NULL;
+	}
+
+	_dialer_flush_caches();
+
+	dlog_print(DLOG_INFO, LOG_TAG, "resources released, rss %d kB -> %d kB", rss_before, data_get_rss_kb());
+}
+
+/*
+ * @brief Function will be operated when the first frame after resume is rendered
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] e The handle to an Evas canvas to be passed to the callback function
+ * @param[in] event_info The system event information
+ */
+static void _resume_render_post_cb(void *data, Evas *e, void *event_info)
+{
+	evas_event_callback_del_full(e, EVAS_CALLBACK_RENDER_POST, _resume_render_post_cb, data);
+
+	dlog_print(DLOG_INFO, LOG_TAG, "resume to first frame %.2f ms", (ecore_time_get() - s_info.resume_time) * 1000.0);
+}
+
+/*
+ * @brief Function will be operated when the prefetch timer expires
+ * @param[in] data The data to be passed to the callback function
+ */
+static void _prefetch_timer_cb(void *data)
+{
+	_dialer_prefetch_plate(_dialer_plate_next_get());
+}
+
+/*
+ * @brief Function will be operated when the restore job is called
+ * @param[in] data The data to be passed to the callback function
+ */
+static void _restore_job_cb(void *data)
+{
+	s_info.restore_job = NULL;
+
+	/* Current plate comes first, the next level is decoded once the loop is idle */
+	if (s_info.plate_released && s_info.plate_path[0] != '\0')
+		view_dialer_set_plate(s_info.plate_path);
+
+	view_dialer_prefetch_next();
+}
+
+/*
+ * @brief Decode the plate of the next level once the crossfade to this one is over
+ */
+void view_dialer_prefetch_next(void)
+{
+	/* Timer lives in s_info, a level change allocates nothing to schedule it */
+	if (!tick_timer_pending(&s_info.prefetch_timer))
+		tick_timer_add(&s_info.prefetch_timer, VIEW_PREFETCH_DELAY, _prefetch_timer_cb, NULL);
+}
+
+/*
+ * @brief Restore resources released by view_dialer_release_resources() lazily
+ */
+void view_dialer_restore_resources(void)
+{
+	if (s_info.win == NULL)
+		return;
+
+	if (s_info.restore_job == NULL)
+		s_info.restore_job = ecore_job_add(_restore_job_cb, NULL);
+}
+
+/*
+ * @brief Release resources when the application becomes invisible
+ */
+void view_pause(void)
+{
+	s_info.paused = EINA_TRUE;
+
+	/* Countdown goes on from where it was once the plate is back on screen */
+	tick_timer_del(&s_info.longpress);
+	_idle_leave();
+	if (s_info.time_attack && tick_timer_pending(&s_info.countdown)) {
+		s_info.countdown_left = s_info.countdown_deadline - ecore_loop_time_get();
+		_countdown_stop();
+	}
+
+	view_dialer_release_resources();
+}
+
+/*
+ * @brief Restore resources when the application becomes visible
+ */
+void view_resume(void)
+{
+	if (!s_info.paused)
+		return;
+
+	s_info.paused = EINA_FALSE;
+
+	if (s_info.win) {
+		s_info.resume_time = ecore_time_get();
+		evas_event_callback_add(evas_object_evas_get(s_info.win), EVAS_CALLBACK_RENDER_POST, _resume_render_post_cb, NULL);
+	}
+
+	view_dialer_restore_resources();
+	_idle_arm();
+}
+
+/*
+ * @brief Give memory back on low memory event
+ * Visible plate is kept while the application is in the foreground
+ */
+void view_low_memory(void)
+{
+	if (s_info.paused)
+		view_dialer_release_resources();
+	else
+		_dialer_flush_caches();
+}
+
+/*
+ * @brief Decode the plate in the background to make the level change cheap
+ * @param[in] plate Plate to be decoded, index of level_data
+ */
+static void _dialer_prefetch_plate(int plate)
+{
+	char image[PATH_MAX] = { 0, };
+
+	if (plate < 1 || plate > s_info.plate_count || s_info.layout == NULL)
+		return;
+
+	data_get_level_image_path(level_data[plate].image, image, (int)sizeof(image));
+
+	/* Indexed plate needs no decoder, mapping and checking it reads the file in */
+	if (plate_path_is_indexed(image)) {
+		if (s_info.prefetch_plate.map && !strcmp(s_info.prefetch_path, image))
+			return;
+
+		plate_close(&s_info.prefetch_plate);
+		if (plate_open(&s_info.prefetch_plate, image))
+			dlog_print(DLOG_ERROR, LOG_TAG, "failed to open plate %s", image);
+		else
+			snprintf(s_info.prefetch_path, sizeof(s_info.prefetch_path), "%s", image);
+		return;
+	}
+
+	if (s_info.prefetch == NULL) {
+		s_info.prefetch = evas_object_image_add(evas_object_evas_get(s_info.layout));
+		if (s_info.prefetch == NULL) {
+			dlog_print(DLOG_ERROR, LOG_TAG, "failed to create a prefetch image.");
+			return;
+		}
+	}
+
+	/* Image object stays hidden, preload only fills the evas image cache */
+	evas_object_image_file_set(s_info.prefetch, image, NULL);
+	evas_object_image_preload(s_info.prefetch, EINA_FALSE);
+}
+
+/*
+ * @brief Render every glyph of the status texts once with the given style on an offscreen canvas
+ * @param[in] style Text style description used by the entry
+ */
+static void _prewarm_glyphs(const char *style)
+{
+	char glyphs[PREWARM_GLYPHS_MAX] = PREWARM_DIGITS;
+	Evas_Object *text = NULL;
+	Evas_Textblock_Style *ts = NULL;
+	int used = sizeof(PREWARM_DIGITS) - 1;
+	int i;
+
+	if (s_info.prewarm_ee == NULL) {
+		s_info.prewarm_ee = ecore_evas_buffer_new(PREWARM_CANVAS_W, PREWARM_CANVAS_H);
+		if (s_info.prewarm_ee == NULL) {
+			dlog_print(DLOG_ERROR, LOG_TAG, "failed to create a prewarm canvas.");
+			return;
+		}
+	}
+
+	text = evas_object_textblock_add(ecore_evas_get(s_info.prewarm_ee));
+	ts = evas_textblock_style_new();
+	if (text == NULL || ts == NULL) {
+		if (text)
+			evas_object_del(text);
+		if (ts)
+			evas_textblock_style_free(ts);
+		return;
+	}
+
+	evas_textblock_style_set(ts, style);
+	evas_object_textblock_style_set(text, ts);
+	/* Every status string of the active catalog, they are already markup */
+	for (i = 0; i < CATALOG_STR_COUNT && used < (int)sizeof(glyphs) - 2; i++) {
+		glyphs[used++] = ' ';
+		used += catalog_format(glyphs + used, sizeof(glyphs) - used, i, 0, 0);
+	}
+	evas_object_textblock_text_markup_set(text, glyphs);
+	evas_object_resize(text, PREWARM_CANVAS_W, PREWARM_CANVAS_H);
+	evas_object_show(text);
+
+	/* Glyphs are rasterized into the shared font cache on render */
+	ecore_evas_manual_render(s_info.prewarm_ee);
+
+	evas_object_del(text);
+	evas_textblock_style_free(ts);
+}
+
+/*
+ * @brief Decode the plate shown after the first tap, the same way every level prefetches its next plate
+ * @param[in] arg Not used
+ */
+static void _prewarm_plate(const char *arg)
+{
+	view_dialer_prefetch_next();
+}
+
+/*
+ * @brief Recalculate the layout and look up parts touched by the tap path
+ * @param[in] arg Not used
+ */
+static void _prewarm_edje_parts(const char *arg)
+{
+	Evas_Object *edje = NULL;
+
+	if (s_info.layout == NULL)
+		return;
+
+	edje = elm_layout_edje_get(s_info.layout);
+	edje_object_calc_force(edje);
+	edje_object_part_object_get(edje, "sw.button.bg");
+	edje_object_part_object_get(edje, "sw.entry.dial");
+}
+
+static const struct prewarm_step {
+	void (*func)(const char *arg);
+	const char *arg;
+} prewarm_steps[] = {
+	{ _prewarm_glyphs, DIAL_TEXT_STYLE_NORMAL },
+	{ _prewarm_glyphs, DIAL_TEXT_STYLE_SMALL },
+	{ _prewarm_glyphs, DIAL_TEXT_STYLE_SMALLER },
+	{ _prewarm_plate, NULL },
+	{ _prewarm_edje_parts, NULL },
+};
+
+/*
+ * @brief Function will be operated when the main loop is idle, runs one prewarm step per call
+ * @param[in] data The data to be passed to the callback function
+ */
+static Eina_Bool _prewarm_idler_cb(void *data)
+{
+	const struct prewarm_step *step = NULL;
+
+	if (s_info.prewarm_step >= sizeof(prewarm_steps) / sizeof(prewarm_steps[0])) {
+		s_info.prewarm_idler = NULL;
+		view_prewarm_cancel();
+		dlog_print(DLOG_DEBUG, LOG_TAG, "prewarm done");
+		return ECORE_CALLBACK_CANCEL;
+	}
+
+	step = &prewarm_steps[s_info.prewarm_step++];
+	step->func(step->arg);
+
+	return ECORE_CALLBACK_RENEW;
+}
+
+/*
+ * @brief Start warming caches in idle time while the greeting screen is shown
+ */
+void view_prewarm_start(void)
+{
+	if (s_info.prewarm_idler)
+		return;
+
+	s_info.prewarm_step = 0;
+	s_info.prewarm_idler = ecore_idler_add(_prewarm_idler_cb, NULL);
+}
+
+/*
+ * @brief Stop warming caches and free the offscreen canvas
+ */
+void view_prewarm_cancel(void)
+{
+	if (s_info.prewarm_idler) {
+		ecore_idler_del(s_info.prewarm_idler);
+		s_info.prewarm_idler = NULL;
+	}
+
+	if (s_info.prewarm_ee) {
+		ecore_evas_free(s_info.prewarm_ee);
+		s_info.prewarm_ee = NULL;
+	}
+}
+
+/*
+ * @brief Feed one recorded event to the canvas, it reaches the rectangle callbacks like a real touch
+ * @param[in] ev Recorded event
+ */
+static void _replay_feed(const trace_event_s *ev)
+{
+	Evas *evas = evas_object_evas_get(s_info.win);
+	unsigned int timestamp = (unsigned int)(s_info.replay_start * 1000.0) + (ev->timestamp - s_info.replay_first_ts);
+
+	evas_event_feed_mouse_move(evas, ev->x, ev->y, timestamp, NULL);
+
+	if (ev->type == TRACE_EVENT_DOWN)
+		evas_event_feed_mouse_down(evas, 1, EVAS_BUTTON_NONE, timestamp, NULL);
+	else if (ev->type == TRACE_EVENT_UP)
+		evas_event_feed_mouse_up(evas, 1, EVAS_BUTTON_NONE, timestamp, NULL);
+}
+
+/*
+ * @brief Function will be operated when the next recorded event is due
+ * @param[in] data The data to be passed to the callback function
+ */
+static void _replay_timer_cb(void *data)
+{
+	double due;
+	int ret;
+
+	_replay_feed(&s_info.replay_event);
+
+	ret = trace_reader_next(&s_info.replay, &s_info.replay_event);
+	if (ret != 1) {
+		if (ret < 0)
+			dlog_print(DLOG_ERROR, LOG_TAG, "touch trace is broken.");
+		dlog_print(DLOG_INFO, LOG_TAG, "replay done in %.1f ms", (ecore_time_get() - s_info.replay_start) * 1000.0);
+		trace_reader_close(&s_info.replay);
+		return;
+	}
+
+	/* One event per frame at max speed, so every event still gets its frame */
+	due = 0.0;
+	if (!s_info.replay_max_speed) {
+		due = s_info.replay_start + (s_info.replay_event.timestamp - s_info.replay_first_ts) / 1000.0 - ecore_time_get();
+		if (due < 0.0)
+			due = 0.0;
+	}
+
+	tick_timer_add(&s_info.replay_timer, due, _replay_timer_cb, NULL);
+}
+
+/*
+ * @brief Replay a recorded touch trace through the rectangle callbacks
+ * @param[in] path Path of the trace file
+ * @param[in] max_speed EINA_TRUE to ignore recorded timing
+ */
+int view_dialer_replay_trace(const char *path, Eina_Bool max_speed)
+{
+	if (s_info.win == NULL || path == NULL) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "cannot replay touch trace.");
+		return -1;
+	}
+
+	view_dialer_stop_replay();
+
+	if (trace_reader_open(&s_info.replay, path)) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to open touch trace %s.", path);
+		return -1;
+	}
+
+	if (trace_reader_next(&s_info.replay, &s_info.replay_event) != 1) {
+		trace_reader_close(&s_info.replay);
+		return -1;
+	}
+
+	/* Replayed events must not end up in a trace being recorded */
+	trace_recorder_stop();
+
+	s_info.replay_max_speed = max_speed;
+	s_info.replay_start = ecore_time_get();
+	s_info.replay_first_ts = s_info.replay_event.timestamp;
+	tick_timer_add(&s_info.replay_timer, 0.0, _replay_timer_cb, NULL);
+
+	return 0;
+}
+
+/*
+ * @brief Stop a running replay
+ */
+void view_dialer_stop_replay(void)
+{
+	tick_timer_del(&s_info.replay_timer);
+
+	trace_reader_close(&s_info.replay);
+}
+
+/*
+ * @brief Check whether a touch trace is being replayed
+ */
+Eina_Bool view_dialer_replay_running(void)
+{
+	return tick_timer_pending(&s_info.replay_timer);
+}
+
+/*
+ * @brief Show the plate with status text of the level
+ * @param[in] level Level to be shown, from 1 to the total level
+ * @param[in] plate Plate to be shown, index of level_data
+ */
+static void _dialer_show_level(int level, int plate)
+{
+	if (level < 1 || level > s_info.total_level) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "level %d is out of range.", level);
+		return;
+	}
+
+	if (plate < 1 || plate > s_info.plate_count) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "plate %d is out of range.", plate);
+		return;
+	}
+
+	s_info.level = level;
+	s_info.plate = plate;
+	s_info.plate_next = -1;
+	sampler_shown(plate - 1);
+	if (s_info.time_attack)
+		_countdown_stop();
+
+	/* Level may be set without a touch, e.g. on restore */
+	_idle_leave();
+	_idle_arm();
+
+	_dialer_transition_begin();
+	if (level_data[s_info.plate].layout != s_info.dial_layout)
+		_dialer_layout_set(level_data[s_info.plate].layout);
+
+	/* Path is built right into the plate path buffer, no allocation */
+	data_get_level_image_path(level_data[s_info.plate].image, s_info.plate_path, (int)sizeof(s_info.plate_path));
+	s_info.plate_variant = level_data[s_info.plate].variant;
+	view_dialer_set_plate(s_info.plate_path);
+	view_dialer_prefetch_next();
+
+	view_dialer_set_status(CATALOG_STR_LEVEL, s_info.level, 0);
+}
+
+/*
+ * @brief Show a status string of the active catalog
+ * @param[in] id Id of the string
+ * @param[in] a Number of slot 0
+ * @param[in] b Number of slot 1
+ */
+void view_dialer_set_status(catalog_str_e id, int a, int b)
+{
+	char text[VIEW_STATUS_MAX];
+
+	s_info.status = id;
+	s_info.status_args[0] = a;
+	s_info.status_args[1] = b;
+
+	catalog_format(text, sizeof(text), id, a, b);
+	view_dialer_set_entry_text(ENTRY_TEXT_SHOW, text);
+
+	/* Text may change without a touch, e.g. on a language change, it must not wait in idle mode */
+	_idle_leave();
+	_idle_arm();
+}
+
+/*
+ * @brief Format the status string on screen again, e.g. with the catalog of a new language
+ */
+void view_dialer_refresh_status(void)
+{
+	if (s_info.status >= CATALOG_STR_COUNT)
+		return;
+
+	view_dialer_set_status(s_info.status, s_info.status_args[0], s_info.status_args[1]);
+}
+
+/*
+ * @brief Show the level with a plate picked by difficulty for the skill of the player
+ * @param[in] level Level to be shown, from 1 to the total level
+ */
+void view_dialer_set_level(int level)
+{
+	_dialer_show_level(level, _dialer_plate_next_get());
+}
+
+/*
+ * @brief Set best score, e.g. restored from saved progress
+ * @param[in] best_score Best score
+ */
+void view_dialer_set_best_score(int best_score)
+{
+	s_info.best_score = best_score;
+}
+
+/*
+ * @brief Count objects of the scene graph below the object and the bytes of their decoded images
+ * @param[in] obj Root of the subtree
+ * @param[out] image_bytes Decoded image bytes to be added to
+ * Returns number of objects including the root
+ */
+static int _stats_object_count(const Evas_Object *obj, unsigned long *image_bytes)
+{
+	Eina_List *members = NULL;
+	Evas_Object *member = NULL;
+	const char *type = evas_object_type_get(obj);
+	int count = 1;
+	int w = 0;
+	int h = 0;
+
+	if (type && !strcmp(type, "image")) {
+		evas_object_image_size_get(obj, &w, &h);
+		*image_bytes += (unsigned long)w * h * 4;
+	}
+
+	members = evas_object_smart_members_get(obj);
+	EINA_LIST_FREE(members, member)
+		count += _stats_object_count(member, image_bytes);
+
+	return count;
+}
+
+/*
+ * @brief Get decoded size of an image object in kB, 0 if there is none
+ * @param[in] image Evas image object
+ */
+static int _stats_image_kb(const Evas_Object *image)
+{
+	int w = 0;
+	int h = 0;
+
+	if (image == NULL)
+		return 0;
+
+	evas_object_image_size_get(image, &w, &h);
+	return w * h * 4 / 1024;
+}
+
+/*
+ * @brief Function will be operated when the stats job is called
+ * @param[in] data The data to be passed to the callback function
+ */
+static void _stats_job_cb(void *data)
+{
+	/* Own members are a few hundred characters at most, the stats members are bounded by the data module */
+	char line[512 + DATA_STATS_JSON_MAX] = { 0, };
+	unsigned long image_bytes = 0;
+	Evas_Object *plate = NULL;
+	perf_activity_s activity;
+	int objects = 0;
+	int image_cache_kb = 0;
+	int used;
+	int n;
+
+	s_info.stats_job = NULL;
+
+	if (s_info.win) {
+		objects = _stats_object_count(s_info.win, &image_bytes);
+		image_cache_kb = evas_image_cache_get(evas_object_evas_get(s_info.win)) / 1024;
+	}
+
+	if (s_info.layout && !s_info.plate_released)
+		plate = elm_object_part_content_get(s_info.layout, "sw.button.bg");
+
+	perf_activity_get(&activity);
+
+	/* Room for the closing brace is always kept */
+	used = snprintf(line, sizeof(line) - 1, "{\"t\":%.3f,\"level\":%d,\"plate\":%d,\"skill\":%.1f,\"objects\":%d,\"image_kb\":%lu,\"image_cache_max_kb\":%d,"
+			"\"plate_kb\":%d,\"prefetch_kb\":%d,\"rss_kb\":%d,\"stalls\":%d,\"wakeups\":%u,\"renders\":%u,"
+			"\"reaction_dropped\":%u,\"feedback_latency_max_ms\":%.2f",
+			activity.time, s_info.level, s_info.plate, sampler_skill_get(), objects, image_bytes / 1024, image_cache_kb,
+			_stats_image_kb(plate == NULL || evas_object_data_get(plate, VIEW_PLATE_INDEXED_KEY) ? plate : elm_image_object_get(plate)),
+			_stats_image_kb(s_info.prefetch) + (int)(s_info.prefetch_plate.size / 1024), data_get_rss_kb(),
+			perf_stall_count_get(), activity.wakeups, activity.renders,
+			reaction_dropped_get(), feedback_latency_max_get());
+
+	if (used < 0 || used >= (int)sizeof(line) - 1) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "stats line is too long.");
+		return;
+	}
+
+	/* Stats members follow a comma only if all of them fit */
+	n = data_stats_json_get(line + used + 1, sizeof(line) - used - 2, s_info.total_level);
+	if (n > 0) {
+		line[used] = ',';
+		used += 1 + n;
+	}
+	line[used++] = '}';
+	line[used] = '\0';
+
+	dlog_print(DLOG_INFO, LOG_TAG, "stats %s", line);
+	data_stats_dump_append(line);
+}
+
+/*
+ * @brief Collect runtime stats in a job and write them as one JSON line to DATA_STATS_DUMP_FILE and dlog
+ */
+void view_stats_dump(void)
+{
+	if (s_info.stats_job == NULL)
+		s_info.stats_job = ecore_job_add(_stats_job_cb, NULL);
+}
+
+/*
+ * @brief Queue the next automation command run
+ */
+static void _automation_kick(void)
+{
+	if (s_info.automation_job == NULL && s_info.entry)
+		s_info.automation_job = ecore_job_add(_automation_job_cb, NULL);
+}
+
+/*
+ * @brief Finish the running command and go on with the next one
+ */
+static void _automation_done(void)
+{
+	s_info.automation_busy = EINA_FALSE;
+	_automation_kick();
+}
+
+/*
+ * @brief Function will be operated when the finger of a synthetic tap is to be lifted
+ * @param[in] data The data to be passed to the callback function
+ */
+static void _automation_tap_up_cb(void *data)
+{
+	Evas *evas = evas_object_evas_get(s_info.win);
+
+	evas_event_feed_mouse_up(evas, 1, EVAS_BUTTON_NONE, (unsigned int)(ecore_time_get() * 1000.0), NULL);
+	_automation_done();
+}
+
+/*
+ * @brief Feed a touch at the position, it reaches the rectangle callbacks like a real touch
+ * Finger is lifted on the next frame
+ * @param[in] x X-coordinate of the touch
+ * @param[in] y Y-coordinate of the touch
+ */
+static void _automation_tap(int x, int y)
+{
+	Evas *evas = evas_object_evas_get(s_info.win);
+	unsigned int timestamp = (unsigned int)(ecore_time_get() * 1000.0);
+
+	evas_event_feed_mouse_move(evas, x, y, timestamp, NULL);
+	evas_event_feed_mouse_down(evas, 1, EVAS_BUTTON_NONE, timestamp, NULL);
+
+	tick_timer_add(&s_info.automation_timer, 0.0, _automation_tap_up_cb, NULL);
+}
+
+/*
+ * @brief Compare function for sorting benchmark samples
+ */
+static int _bench_sample_cmp(const void *a, const void *b)
+{
+	unsigned int x = *(const unsigned int *)a;
+	unsigned int y = *(const unsigned int *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/*
+ * @brief Print and save results of the transition benchmark
+ */
+static void _bench_report(void)
+{
+	char line[256] = { 0, };
+	unsigned int *us = s_info.bench_us;
+	int n = s_info.bench_count;
+
+	if (n > VIEW_BENCH_SAMPLES_MAX)
+		n = VIEW_BENCH_SAMPLES_MAX;
+
+	if (n == 0)
+		return;
+
+	qsort(us, n, sizeof(us[0]), _bench_sample_cmp);
+
+	snprintf(line, sizeof(line), "{\"bench\":\"transitions\",\"n\":%d,\"min_ms\":%.2f,\"p50_ms\":%.2f,\"p95_ms\":%.2f,"
+			"\"max_ms\":%.2f,\"rss_kb_start\":%d,\"rss_kb_end\":%d}",
+			n, us[0] / 1000.0, us[n / 2] / 1000.0, us[n * 95 / 100] / 1000.0, us[n - 1] / 1000.0,
+			s_info.bench_rss_start, data_get_rss_kb());
+
+	dlog_print(DLOG_INFO, LOG_TAG, "%s", line);
+	data_stats_dump_append(line);
+}
+
+/*
+ * @brief Set the next level of the transition benchmark
+ * @param[in] data The data to be passed to the callback function
+ */
+static void _bench_transition_cb(void *data)
+{
+	if (s_info.bench_count >= s_info.bench_total || s_info.paused) {
+		s_info.bench_start = 0.0;
+		_bench_report();
+		_automation_done();
+		return;
+	}
+
+	s_info.bench_start = perf_time_get();
+	/* Every plate in turn, transitions are comparable between runs */
+	_dialer_show_level(s_info.bench_count % s_info.total_level + 1, s_info.bench_count % s_info.plate_count + 1);
+}
+
+/*
+ * @brief Record the transition shown in this frame and start the next one on the next frame
+ */
+static void _bench_transition_done(void)
+{
+	if (s_info.bench_count < VIEW_BENCH_SAMPLES_MAX)
+		s_info.bench_us[s_info.bench_count] = (unsigned int)((s_info.plate_shown - s_info.bench_start) * 1000000.0);
+	s_info.bench_count++;
+	s_info.bench_start = 0.0;
+
+	tick_timer_add(&s_info.automation_timer, 0.0, _bench_transition_cb, NULL);
+}
+
+/*
+ * @brief Run every level transition the given number of times
+ * @param[in] repeat Number of rounds
+ */
+static void _bench_transitions(int repeat)
+{
+	if (s_info.time_attack)
+		_time_attack_finish(0);
+
+	s_info.bench_count = 0;
+	/* Nothing to show if the plates failed to be indexed */
+	s_info.bench_total = s_info.plate_count > 0 ? repeat * s_info.total_level : 0;
+	if (s_info.bench_total > VIEW_BENCH_SAMPLES_MAX)
+		s_info.bench_total = VIEW_BENCH_SAMPLES_MAX;
+	s_info.bench_rss_start = data_get_rss_kb();
+
+	_bench_transition_cb(NULL);
+}
+
+/*
+ * @brief Function will be operated when the automation job is called, starts the next queued command
+ * @param[in] data The data to be passed to the callback function
+ */
+static void _automation_job_cb(void *data)
+{
+	struct automation_command *cmd = NULL;
+
+	s_info.automation_job = NULL;
+
+	if (s_info.automation_busy || s_info.automation_tail == s_info.automation_head)
+		return;
+
+	cmd = &s_info.automation[s_info.automation_tail++ & (VIEW_AUTOMATION_QUEUE_SIZE - 1)];
+	s_info.automation_busy = EINA_TRUE;
+
+	switch (cmd->command) {
+	case VIEW_AUTOMATION_LEVEL:
+		/* Scripted runs get the same plate every time */
+		_dialer_show_level(cmd->a, cmd->a);
+		break;
+	case VIEW_AUTOMATION_TAP:
+		_automation_tap(cmd->a, cmd->b);
+		return;
+	case VIEW_AUTOMATION_TAP_SECTOR:
+		if (cmd->a < 0 || cmd->a >= dial_layout_targets_get(s_info.dial_layout))
+			break;
+		_automation_tap((int)(s_info.sector_center[cmd->a][0] * 2 * CENTER_REF_X), (int)(s_info.sector_center[cmd->a][1] * 2 * CENTER_REF_Y));
+		return;
+	case VIEW_AUTOMATION_BENCH_TRANSITIONS:
+		_bench_transitions(cmd->a > 0 ? cmd->a : 1);
+		return;
+	case VIEW_AUTOMATION_CACHE_RESET:
+		_dialer_flush_caches();
+		break;
+	case VIEW_AUTOMATION_STATS:
+		view_stats_dump();
+		break;
+	default:
+		dlog_print(DLOG_ERROR, LOG_TAG, "unknown automation command %d", cmd->command);
+		break;
+	}
+
+	_automation_done();
+}
+
+/*
+ * @brief Queue an automation command, commands run in order in the main loop once the view is ready
+ * @param[in] command Command to be run
+ * @param[in] a Level, x-coordinate, sector or number of rounds depending on the command
+ * @param[in] b Y-coordinate for VIEW_AUTOMATION_TAP
+ */
+int view_automation_queue(view_automation_e command, int a, int b)
+{
+	struct automation_command *cmd = NULL;
+
+	if (s_info.automation_head - s_info.automation_tail >= VIEW_AUTOMATION_QUEUE_SIZE) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "automation queue is full.");
+		return -1;
+	}
+
+	cmd = &s_info.automation[s_info.automation_head++ & (VIEW_AUTOMATION_QUEUE_SIZE - 1)];
+	cmd->command = command;
+	cmd->a = a;
+	cmd->b = b;
+
+	_automation_kick();
+
+	return 0;
 }
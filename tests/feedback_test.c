@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Feedback mixer test on a plain Linux host, with the file sink in place of audio_io.
+ * Three cues are played one after another and the PCM file is checked against their lengths
+ * in cue_descs of src/feedback.c: every cue starts at a period boundary, fills whole periods with
+ * silence after its end and nothing else is written. Latency from feedback_play() to mixing is printed.
+ *
+ * Build:
+ *   gcc -std=gnu99 -O2 -DFEEDBACK_NO_DEVICE -Iinc -Itests/host tests/feedback_test.c src/feedback.c \
+ *       -o feedback_test -lpthread -lm
+ *
+ * Run:
+ *   ./feedback_test
+ * Exit status is 1 if the PCM is not as expected.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dlog.h>
+#include "feedback.h"
+
+/* Length of each cue in cue_descs of src/feedback.c, ms */
+#define TEST_TAP_MS 15
+#define TEST_RIGHT_MS 140
+#define TEST_WRONG_MS 220
+/* Samples of the cues peak at 12000, a cue must be clearly audible */
+#define TEST_PEAK_MIN 4000
+/* Every cue is mixed within this many periods of feedback_play() */
+#define TEST_LATENCY_PERIODS_MAX 4
+
+static struct test_cue {
+	feedback_cue_e cue;
+	int ms;
+	const char *name;
+} test_cues[] = {
+	{ FEEDBACK_CUE_TAP, TEST_TAP_MS, "tap" },
+	{ FEEDBACK_CUE_RIGHT, TEST_RIGHT_MS, "right" },
+	{ FEEDBACK_CUE_WRONG, TEST_WRONG_MS, "wrong" },
+};
+
+int dlog_print(log_priority prio, const char *tag, const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fputc('\n', stderr);
+
+	return 0;
+}
+
+/*
+ * @brief Check one cue in the PCM
+ * @param[in] pcm First frame of the cue
+ * @param[in] frames Frames of the cue
+ * @param[in] padded Frames up to the next period boundary
+ * @param[in] name Name of the cue
+ */
+static int _test_cue_check(const short *pcm, int frames, int padded, const char *name)
+{
+	int peak = 0;
+	int i;
+
+	for (i = 0; i < frames; i++)
+		if (abs(pcm[i]) > peak)
+			peak = abs(pcm[i]);
+
+	if (peak < TEST_PEAK_MIN) {
+		fprintf(stderr, "%s: peak %d is too low\n", name, peak);
+		return -1;
+	}
+
+	for (i = frames; i < padded; i++) {
+		if (pcm[i]) {
+			fprintf(stderr, "%s: frame %d after the cue is %d, not silence\n", name, i, pcm[i]);
+			return -1;
+		}
+	}
+
+	printf("%s: %d frames, peak %d\n", name, frames, peak);
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	char path[] = "/tmp/feedback_test.XXXXXX";
+	short *pcm = NULL;
+	long size;
+	FILE *fp = NULL;
+	int expected = 0;
+	int offset = 0;
+	int frames, padded;
+	int failed = 0;
+	int fd;
+	int i;
+
+	fd = mkstemp(path);
+	if (fd < 0) {
+		perror("mkstemp");
+		return 2;
+	}
+	close(fd);
+
+	if (feedback_start(FEEDBACK_SINK_FILE, path)) {
+		fprintf(stderr, "failed to start the file sink\n");
+		return 2;
+	}
+
+	/* Each cue ends before the next one, so the cues follow each other in the file */
+	for (i = 0; i < (int)(sizeof(test_cues) / sizeof(test_cues[0])); i++) {
+		feedback_play(test_cues[i].cue);
+		usleep((test_cues[i].ms + 100) * 1000);
+		expected += (test_cues[i].ms * FEEDBACK_RATE / 1000 + FEEDBACK_PERIOD - 1) / FEEDBACK_PERIOD * FEEDBACK_PERIOD;
+	}
+	feedback_stop();
+
+	printf("played %u dropped %u latency max %.2f ms\n", feedback_played_get(), feedback_dropped_get(), feedback_latency_max_get());
+	if (feedback_played_get() != sizeof(test_cues) / sizeof(test_cues[0]) || feedback_dropped_get()) {
+		fprintf(stderr, "cues are missing\n");
+		failed = 1;
+	}
+	if (feedback_latency_max_get() > TEST_LATENCY_PERIODS_MAX * 1000.0 * FEEDBACK_PERIOD / FEEDBACK_RATE) {
+		fprintf(stderr, "latency is over %d periods\n", TEST_LATENCY_PERIODS_MAX);
+		failed = 1;
+	}
+
+	fp = fopen(path, "rb");
+	if (fp == NULL) {
+		perror(path);
+		return 2;
+	}
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	rewind(fp);
+
+	pcm = malloc(size > 0 ? size : 1);
+	if (pcm == NULL || fread(pcm, 1, size, fp) != (size_t)size) {
+		fprintf(stderr, "failed to read %s\n", path);
+		return 2;
+	}
+	fclose(fp);
+	unlink(path);
+
+	if (size != (long)(expected * sizeof(short))) {
+		fprintf(stderr, "PCM has %ld frames, expected %d\n", size / (long)sizeof(short), expected);
+		failed = 1;
+	} else {
+		for (i = 0; i < (int)(sizeof(test_cues) / sizeof(test_cues[0])); i++) {
+			frames = test_cues[i].ms * FEEDBACK_RATE / 1000;
+			padded = (frames + FEEDBACK_PERIOD - 1) / FEEDBACK_PERIOD * FEEDBACK_PERIOD;
+			if (_test_cue_check(pcm + offset, frames, padded, test_cues[i].name))
+				failed = 1;
+			offset += padded;
+		}
+	}
+
+	free(pcm);
+
+	return failed;
+}
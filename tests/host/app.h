@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/* Host stand-in for the Tizen header, only what the pure C modules use. See tests/tap_alloc_test.c */
+
+#if !defined(_HOST_APP_H)
+#define _HOST_APP_H
+
+#include <limits.h>
+
+/* Both return a copy the caller frees */
+char *app_get_resource_path(void);
+char *app_get_data_path(void);
+/* Only src/view.c calls it, see tests/view_replay_test.c */
+void ui_app_exit(void);
+#endif
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/* Host stand-in for the Tizen header, only what the pure C modules use. See tests/tap_alloc_test.c */
+
+#if !defined(_HOST_DLOG_H)
+#define _HOST_DLOG_H
+
+typedef enum {
+	DLOG_DEBUG = 3,
+	DLOG_INFO,
+	DLOG_WARN,
+	DLOG_ERROR
+} log_priority;
+
+int dlog_print(log_priority prio, const char *tag, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+#endif
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Host stand-in for the Tizen header. The pure C modules need nothing of it, see tests/tap_alloc_test.c.
+ * Built against Elementary, see tests/view_replay_test.c, src/view.c gets the back key API, which never fires on a host.
+ */
+
+#if !defined(_HOST_EFL_EXTENSION_H)
+#define _HOST_EFL_EXTENSION_H
+
+#if __has_include(<Elementary.h>)
+#include <Elementary.h>
+
+typedef enum {
+	EEXT_CALLBACK_BACK = 0,
+	EEXT_CALLBACK_MORE
+} Eext_Callback_Type;
+
+typedef void (*Eext_Event_Cb)(void *data, Evas_Object *obj, void *event_info);
+
+void eext_object_event_callback_add(Evas_Object *obj, Eext_Callback_Type type, Eext_Event_Cb func, void *data);
+#endif
+#endif
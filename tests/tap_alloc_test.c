@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Allocation test of the tap to level advance path on a plain Linux host.
+ * The modules of that path which build without EFL run as the mouse up of src/view.c drives them:
+ * trace recording, hit test, reaction ring, sampler, plate path, indexed plate expansion and prefetch,
+ * status formatting, progress log and leaderboard. malloc, calloc and realloc are replaced here, so calls
+ * from libc itself (strdup, fopen, ...) count too. Every call made on this thread after the warm-up
+ * game counts, threads of the modules do not.
+ * The EFL calls of the callbacks themselves are not part of this test, tests/view_replay_test.c counts
+ * the allocations of the real callbacks of src/view.c around fed taps.
+ *
+ * Build:
+ *   gcc -O2 -Iinc -Itests/host tests/tap_alloc_test.c src/data.c src/dial.c src/sampler.c src/reaction.c \
+ *       src/trace.c src/catalog.c src/plate.c -o tap_alloc_test -lpthread -lm
+ *
+ * Run:
+ *   ./tap_alloc_test [-n games] res/
+ * Exit status is 1 if anything is allocated on the path.
+ */
+
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dlog.h>
+#include <app.h>
+#include "catalog.h"
+#include "data.h"
+#include "dial.h"
+#include "plate.h"
+#include "reaction.h"
+#include "sampler.h"
+#include "trace.h"
+
+#define TEST_LEVELS 20
+#define TEST_PLATE_SIZE 360
+/* VIEW_STATUS_MAX of inc/view.h, which needs EFL */
+#define TEST_STATUS_MAX 128
+
+/* Allocator of glibc under the names it keeps for replacements like these */
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t nmemb, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+/* Only allocations of the thread running the path count */
+static __thread int s_counting;
+
+static struct test_info {
+	char res_path[PATH_MAX];
+	char data_path[PATH_MAX];
+	unsigned long allocs;
+
+	unsigned int pixels[TEST_PLATE_SIZE * TEST_PLATE_SIZE];
+	char plate_path[PATH_MAX];
+	plate_s prefetch;
+	char prefetch_path[PATH_MAX];
+	unsigned int run_times[DATA_STATS_LEVEL_MAX + 1];
+	unsigned char difficulty[TEST_LEVELS];
+	unsigned int timestamp;
+	int best_score;
+} s_info = {
+	.res_path = { 0, },
+	.data_path = { 0, },
+	.allocs = 0,
+
+	.prefetch = { 0, },
+	.timestamp = 0,
+	.best_score = 0,
+};
+
+void *malloc(size_t size)
+{
+	s_info.allocs += s_counting;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	s_info.allocs += s_counting;
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	s_info.allocs += s_counting;
+	return __libc_realloc(ptr, size);
+}
+
+int dlog_print(log_priority prio, const char *tag, const char *fmt, ...)
+{
+	va_list ap;
+
+	if (prio < DLOG_WARN)
+		return 0;
+
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fputc('\n', stderr);
+
+	return 0;
+}
+
+char *app_get_resource_path(void)
+{
+	return strdup(s_info.res_path);
+}
+
+char *app_get_data_path(void)
+{
+	return strdup(s_info.data_path);
+}
+
+/*
+ * @brief Show the plate of the level the way view_dialer_set_plate() does, from the prefetch if it is there
+ * @param[in] plate Plate of the level, from 1
+ */
+static int _test_plate_show(int plate)
+{
+	char name[32];
+	plate_s current;
+
+	snprintf(name, sizeof(name), "lv%d.gip", plate);
+	data_get_level_image_path(name, s_info.plate_path, (int)sizeof(s_info.plate_path));
+
+	if (s_info.prefetch.map && !strcmp(s_info.prefetch_path, s_info.plate_path)) {
+		current = s_info.prefetch;
+		memset(&s_info.prefetch, 0, sizeof(s_info.prefetch));
+	} else if (plate_open(&current, s_info.plate_path)) {
+		fprintf(stderr, "failed to open %s\n", s_info.plate_path);
+		return -1;
+	}
+
+	plate_expand(&current, 0, s_info.pixels, TEST_PLATE_SIZE);
+	plate_close(&current);
+
+	return 0;
+}
+
+/*
+ * @brief Map the next plate the way _dialer_prefetch_plate() does
+ * @param[in] plate Next plate, from 1
+ */
+static void _test_plate_prefetch(int plate)
+{
+	char name[32];
+
+	snprintf(name, sizeof(name), "lv%d.gip", plate);
+	data_get_level_image_path(name, s_info.prefetch_path, (int)sizeof(s_info.prefetch_path));
+
+	plate_close(&s_info.prefetch);
+	if (plate_open(&s_info.prefetch, s_info.prefetch_path))
+		fprintf(stderr, "failed to open %s\n", s_info.prefetch_path);
+}
+
+/*
+ * @brief Tap a sector of the plate on screen, then advance or end the run as the mouse up does
+ * @param[in] level Level on screen
+ * @param[in] plate Plate on screen
+ * @param[in] right Whether the tap answers right
+ * Returns the plate of the next level, 0 when the run is over
+ */
+static int _test_tap(int level, int plate, int right)
+{
+	char status[TEST_STATUS_MAX];
+	reaction_sample_s sample = { 0, };
+	double cx, cy;
+	double skill;
+	int sector = (plate + (right ? 0 : 1)) % DIAL_SECTOR_COUNT;
+	int x, y;
+	int next;
+
+	dial_layout_center_get(DIAL_LAYOUT_10, sector, &cx, &cy);
+	x = (int)(cx * TEST_PLATE_SIZE);
+	y = (int)(cy * TEST_PLATE_SIZE);
+
+	s_info.timestamp += 400;
+	trace_recorder_add(TRACE_EVENT_DOWN, x, y, s_info.timestamp);
+	sector = dial_layout_sector_get(DIAL_LAYOUT_10, x, y);
+	s_info.timestamp += 80;
+	trace_recorder_add(TRACE_EVENT_UP, x, y, s_info.timestamp);
+
+	sample.reaction_us = 400000;
+	sample.level = (unsigned char)level;
+	sample.answer = (unsigned char)sector;
+	sample.tapped = (signed char)sector;
+	reaction_push(&sample);
+	s_info.run_times[level] = sample.reaction_us / 1000;
+
+	sampler_answer(plate - 1, right);
+	if (!right || level == TEST_LEVELS) {
+		catalog_format(status, sizeof(status), right ? CATALOG_STR_CLEAR : CATALOG_STR_SCORE, level, 0);
+		if (s_info.best_score < level)
+			s_info.best_score = level;
+		data_stats_add_run(right ? level : level - 1, s_info.run_times, TEST_LEVELS + 1);
+		memset(s_info.run_times, 0, sizeof(s_info.run_times));
+		data_progress_save(0, s_info.best_score);
+		return 0;
+	}
+
+	skill = sampler_skill_update(sampler_skill_get(), s_info.difficulty[plate - 1], 1);
+	next = sampler_pick(skill) + 1;
+	sampler_shown(next - 1);
+
+	if (_test_plate_show(next))
+		return -1;
+	catalog_format(status, sizeof(status), CATALOG_STR_LEVEL, level + 1, 0);
+	data_progress_save(level + 1, s_info.best_score);
+
+	/* Next plate of a right answer, as _dialer_plate_next_get() picks it */
+	_test_plate_prefetch(sampler_pick(sampler_skill_update(skill, s_info.difficulty[next - 1], 1)) + 1);
+
+	return next;
+}
+
+/*
+ * @brief Play one game from the greeting, the last level is missed every other game
+ * @param[in] game Number of the game
+ */
+static int _test_game(int game)
+{
+	int plate = sampler_pick(sampler_skill_get()) + 1;
+	int level;
+
+	sampler_shown(plate - 1);
+	if (_test_plate_show(plate))
+		return -1;
+
+	for (level = 1; level <= TEST_LEVELS && plate > 0; level++)
+		plate = _test_tap(level, plate, level < TEST_LEVELS || game % 2);
+
+	return plate < 0 ? -1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	char path[PATH_MAX];
+	int games = 50;
+	int opt;
+	int i;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		switch (opt) {
+		case 'n':
+			games = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-n games] res/\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (optind != argc - 1) {
+		fprintf(stderr, "usage: %s [-n games] res/\n", argv[0]);
+		return 2;
+	}
+
+	/* Paths of the app end with a slash */
+	snprintf(s_info.res_path, sizeof(s_info.res_path), "%s%s", argv[optind],
+			argv[optind][strlen(argv[optind]) - 1] == '/' ? "" : "/");
+	snprintf(s_info.data_path, sizeof(s_info.data_path), "/tmp/tap_alloc_test.XXXXXX");
+	if (mkdtemp(s_info.data_path) == NULL) {
+		perror("mkdtemp");
+		return 2;
+	}
+	strcat(s_info.data_path, "/");
+
+	data_initialize();
+
+	data_get_full_path("locale/en.cat", path, (int)sizeof(path));
+	if (catalog_load(path))
+		fprintf(stderr, "failed to load %s, built-in strings are used\n", path);
+
+	for (i = 0; i < TEST_LEVELS; i++)
+		s_info.difficulty[i] = (unsigned char)(i * SAMPLER_DIFFICULTY_MAX / TEST_LEVELS);
+	if (sampler_init(s_info.difficulty, TEST_LEVELS, 1)) {
+		fprintf(stderr, "failed to init the sampler\n");
+		return 2;
+	}
+
+	data_get_data_path(REACTION_FILE, path, (int)sizeof(path));
+	reaction_start(path);
+	data_get_data_path(TRACE_FILE, path, (int)sizeof(path));
+	trace_recorder_start(path);
+
+	/* Buffers of stdio and the first mapping of every plate come from the warm-up */
+	if (_test_game(1))
+		return 2;
+
+	s_counting = 1;
+	for (i = 0; i < games; i++)
+		if (_test_game(i))
+			return 2;
+	s_counting = 0;
+
+	trace_recorder_stop();
+	reaction_stop();
+	plate_close(&s_info.prefetch);
+	sampler_fini();
+	catalog_shutdown();
+	data_finalize();
+
+	/* Data directory is made for this run only */
+	data_get_data_path(DATA_PROGRESS_FILE, path, (int)sizeof(path));
+	unlink(path);
+	data_get_data_path(DATA_STATS_FILE, path, (int)sizeof(path));
+	unlink(path);
+	data_get_data_path(REACTION_FILE, path, (int)sizeof(path));
+	unlink(path);
+	data_get_data_path(TRACE_FILE, path, (int)sizeof(path));
+	unlink(path);
+	data_get_data_path(DATA_RUNS_FILE, path, (int)sizeof(path));
+	unlink(path);
+	rmdir(s_info.data_path);
+
+	printf("%d games, %d taps, %lu allocations\n", games, games * TEST_LEVELS, s_info.allocs);
+
+	return s_info.allocs ? 1 : 0;
+}
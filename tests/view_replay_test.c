@@ -0,0 +1,559 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Touch trace replay of src/view.c on a plain Linux host, on the buffer engine of Elementary.
+ * The app is set up as app_create() and _app_create_deferred_cb() of src/main.c do, the trace goes through
+ * view_dialer_replay_trace(), so every event takes the evas_event_feed_* path of a replay on the watch.
+ * Down and up on the touch rectangle are bracketed by callbacks before and after the ones of the app,
+ * which times the tap callbacks and counts their allocations. malloc, calloc and realloc are replaced here,
+ * as in tests/tap_alloc_test.c, only calls of the main loop thread count.
+ * Taps of the first game warm caches up and do not count. After it a tap may allocate only what setting
+ * the status text of the entry costs: elm_object_text_set() keeps its own copy of every new text, and a tap
+ * changes the text once. That cost is measured before the replay by changing the status once.
+ * Each speed runs in its own process with an empty data directory.
+ *
+ * Build:
+ *   edje_cc -id edje/images res/edje/main.edc res/edje/main.edj
+ *   gcc -O2 -DFEEDBACK_NO_DEVICE -Iinc -Itests/host tests/view_replay_test.c src/view.c src/data.c src/dial.c \
+ *       src/sampler.c src/reaction.c src/trace.c src/catalog.c src/plate.c src/tick.c src/perf.c src/feedback.c \
+ *       src/thumb.c -o view_replay_test $(pkg-config --cflags --libs elementary) -lpthread -lm
+ *
+ * Run:
+ *   ./view_replay_test [-s original|max] res/ touch.trace
+ * Both speeds run when -s is not given. Level, best score, every finished run, the timings and the allocations
+ * are printed, exit status is 1 if a replay fails or a tap allocates more than the status text.
+ */
+
+/* nftw() */
+#define _GNU_SOURCE
+#include <ftw.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <Elementary.h>
+#include <dlog.h>
+#include <app.h>
+#include <efl_extension.h>
+#include "catalog.h"
+#include "view.h"
+#include "data.h"
+#include "feedback.h"
+#include "perf.h"
+#include "reaction.h"
+#include "trace.h"
+
+#define TEST_W 360
+#define TEST_H 360
+/* End of the replay is polled, the replay time itself comes from the last tap */
+#define TEST_POLL_TIME 0.05
+
+/* Allocator of glibc under the names it keeps for replacements like these */
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t nmemb, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+/* Only allocations of the main loop thread inside a tap count */
+static __thread int s_counting;
+
+typedef enum {
+	TEST_SPEED_ORIGINAL = 0,
+	TEST_SPEED_MAX,
+	TEST_SPEED_COUNT
+} test_speed_e;
+
+static const char *test_speed_names[TEST_SPEED_COUNT] = { "original", "max" };
+
+static struct test_info {
+	char res_path[PATH_MAX];
+	char data_path[PATH_MAX];
+	const char *trace_path;
+	int verbose;
+
+	Evas_Object *rect;
+	Ecore_Timer *poll;
+	int failed;
+
+	/* Replay and the taps of it */
+	double replay_start;
+	double replay_end;
+	double tap_start;
+	double tap_max;
+	double tap_total;
+	int taps;
+
+	/* Allocations of the taps after the first game */
+	unsigned long allocs;
+	unsigned long tap_allocs;
+	unsigned long alloc_budget;
+	unsigned long alloc_max;
+	int warm;
+	int level_seen;
+	int counted_taps;
+	int over_budget;
+
+	/* Frames rendered during the replay */
+	double render_start;
+	double render_max;
+	double render_total;
+	int frames;
+} s_info = {
+	.res_path = { 0, },
+	.data_path = { 0, },
+	.trace_path = NULL,
+	.verbose = 0,
+
+	.rect = NULL,
+	.poll = NULL,
+	.failed = 0,
+
+	.replay_start = 0.0,
+	.replay_end = 0.0,
+	.tap_start = 0.0,
+	.tap_max = 0.0,
+	.tap_total = 0.0,
+	.taps = 0,
+
+	.allocs = 0,
+	.tap_allocs = 0,
+	.alloc_budget = 0,
+	.alloc_max = 0,
+	.warm = 0,
+	.level_seen = 0,
+	.counted_taps = 0,
+	.over_budget = 0,
+
+	.render_start = 0.0,
+	.render_max = 0.0,
+	.render_total = 0.0,
+	.frames = 0,
+};
+
+void *malloc(size_t size)
+{
+	s_info.allocs += s_counting;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	s_info.allocs += s_counting;
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	s_info.allocs += s_counting;
+	return __libc_realloc(ptr, size);
+}
+
+int dlog_print(log_priority prio, const char *tag, const char *fmt, ...)
+{
+	va_list ap;
+
+	if (prio < DLOG_WARN && !s_info.verbose)
+		return 0;
+
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fputc('\n', stderr);
+
+	return 0;
+}
+
+char *app_get_resource_path(void)
+{
+	return strdup(s_info.res_path);
+}
+
+char *app_get_data_path(void)
+{
+	return strdup(s_info.data_path);
+}
+
+void ui_app_exit(void)
+{
+	elm_exit();
+}
+
+void eext_object_event_callback_add(Evas_Object *obj, Eext_Callback_Type type, Eext_Event_Cb func, void *data)
+{
+	/* No back key on a host */
+}
+
+/*
+ * @brief Function will be operated before the tap callbacks of the app
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] e The handle to an Evas canvas to be passed to the callback function
+ * @param[in] obj The Evas object handle to be passed to the callback function
+ * @param[in] event_info The system event information
+ */
+static void _test_tap_enter_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
+{
+	s_info.allocs = 0;
+	s_counting = s_info.warm;
+	s_info.tap_start = perf_time_get();
+}
+
+/*
+ * @brief Function will be operated after the tap callbacks of the app
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] e The handle to an Evas canvas to be passed to the callback function
+ * @param[in] obj The Evas object handle to be passed to the callback function
+ * @param[in] event_info The system event information
+ */
+static void _test_tap_leave_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
+{
+	double now = perf_time_get();
+	double duration = now - s_info.tap_start;
+	int level = 0;
+
+	s_counting = 0;
+	s_info.tap_allocs += s_info.allocs;
+
+	s_info.tap_total += duration;
+	if (duration > s_info.tap_max)
+		s_info.tap_max = duration;
+	s_info.taps++;
+	s_info.replay_end = now;
+
+	/* A tap is over with its mouse up */
+	if (data == NULL)
+		return;
+
+	if (s_info.warm) {
+		if (s_info.tap_allocs > s_info.alloc_max)
+			s_info.alloc_max = s_info.tap_allocs;
+		if (s_info.tap_allocs > s_info.alloc_budget)
+			s_info.over_budget++;
+		s_info.counted_taps++;
+	}
+	s_info.tap_allocs = 0;
+
+	/* Progress is saved at the end of every mouse up, level 0 after a level was played is the game over */
+	data_progress_get(&level, NULL);
+	if (level > 0)
+		s_info.level_seen = 1;
+	else if (s_info.level_seen)
+		s_info.warm = 1;
+}
+
+/*
+ * @brief Measure the allocations of one status text change, the only ones a tap is allowed
+ * Text of the same length as a level status is set once to warm the glyphs up, then once counted
+ */
+static void _test_alloc_budget_measure(void)
+{
+	view_dialer_set_status(CATALOG_STR_LEVEL, VIEW_PLATE_MAX - 2, 0);
+
+	s_info.allocs = 0;
+	s_counting = 1;
+	view_dialer_set_status(CATALOG_STR_LEVEL, VIEW_PLATE_MAX - 1, 0);
+	s_counting = 0;
+	s_info.alloc_budget = s_info.allocs;
+
+	view_dialer_set_status(CATALOG_STR_GREETING, 0, 0);
+}
+
+/*
+ * @brief Function will be operated when rendering of a frame starts
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] e The handle to an Evas canvas to be passed to the callback function
+ * @param[in] event_info The system event information
+ */
+static void _test_render_pre_cb(void *data, Evas *e, void *event_info)
+{
+	s_info.render_start = perf_time_get();
+}
+
+/*
+ * @brief Function will be operated when a frame is rendered
+ * @param[in] data The data to be passed to the callback function
+ * @param[in] e The handle to an Evas canvas to be passed to the callback function
+ * @param[in] event_info The system event information
+ */
+static void _test_render_post_cb(void *data, Evas *e, void *event_info)
+{
+	double duration = perf_time_get() - s_info.render_start;
+
+	if (s_info.replay_start == 0.0)
+		return;
+
+	s_info.render_total += duration;
+	if (duration > s_info.render_max)
+		s_info.render_max = duration;
+	s_info.frames++;
+}
+
+/*
+ * @brief Function will be operated until the replay is over
+ * @param[in] data The data to be passed to the callback function
+ */
+static Eina_Bool _test_poll_cb(void *data)
+{
+	if (view_dialer_replay_running())
+		return ECORE_CALLBACK_RENEW;
+
+	s_info.poll = NULL;
+	elm_exit();
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
+/*
+ * @brief Start the replay once the greeting is on screen, as the deferred part of app_create() runs
+ * @param[in] data Speed of the replay
+ */
+static Eina_Bool _test_start_cb(void *data)
+{
+	test_speed_e speed = (test_speed_e)(intptr_t)data;
+
+	_test_alloc_budget_measure();
+
+	s_info.replay_start = perf_time_get();
+	if (view_dialer_replay_trace(s_info.trace_path, speed == TEST_SPEED_MAX)) {
+		s_info.failed = 1;
+		elm_exit();
+		return ECORE_CALLBACK_CANCEL;
+	}
+
+	s_info.poll = ecore_timer_add(TEST_POLL_TIME, _test_poll_cb, NULL);
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
+/*
+ * @brief Set the app up on the buffer engine as src/main.c does on the watch
+ */
+static int _test_app_create(void)
+{
+	char path[PATH_MAX] = { 0, };
+	char *image = NULL;
+	Evas *evas = NULL;
+
+	data_initialize();
+
+	view_create();
+	data_get_full_path(EDJ_FILE, path, (int)sizeof(path));
+	view_dialer_create(path);
+	if (view_dialer_get_layout_object() == NULL)
+		return -1;
+
+	evas = evas_object_evas_get(view_dialer_get_layout_object());
+	evas_object_resize(elm_object_top_widget_get(view_dialer_get_layout_object()), TEST_W, TEST_H);
+
+	image = data_get_image_path("sw.button.bg");
+	view_dialer_set_plate(image);
+	free(image);
+
+	view_dialer_set_entry("sw.entry.dial");
+	s_info.rect = view_dialer_create_rectangle();
+	if (s_info.rect == NULL)
+		return -1;
+
+	/* Brackets of the tap callbacks of the app, which are added with the default priority */
+	evas_object_event_callback_priority_add(s_info.rect, EVAS_CALLBACK_MOUSE_DOWN, EVAS_CALLBACK_PRIORITY_BEFORE, _test_tap_enter_cb, NULL);
+	evas_object_event_callback_priority_add(s_info.rect, EVAS_CALLBACK_MOUSE_DOWN, EVAS_CALLBACK_PRIORITY_AFTER, _test_tap_leave_cb, NULL);
+	evas_object_event_callback_priority_add(s_info.rect, EVAS_CALLBACK_MOUSE_UP, EVAS_CALLBACK_PRIORITY_BEFORE, _test_tap_enter_cb, NULL);
+	evas_object_event_callback_priority_add(s_info.rect, EVAS_CALLBACK_MOUSE_UP, EVAS_CALLBACK_PRIORITY_AFTER, _test_tap_leave_cb, s_info.rect);
+
+	evas_event_callback_add(evas, EVAS_CALLBACK_RENDER_PRE, _test_render_pre_cb, NULL);
+	evas_event_callback_add(evas, EVAS_CALLBACK_RENDER_POST, _test_render_post_cb, NULL);
+
+	view_dialer_set_status(CATALOG_STR_GREETING, 0, 0);
+
+	data_get_data_path(REACTION_FILE, path, (int)sizeof(path));
+	if (reaction_start(path))
+		fprintf(stderr, "failed to open %s\n", path);
+	feedback_start(FEEDBACK_SINK_NULL, NULL);
+
+	view_dialer_prefetch_next();
+	view_prewarm_start();
+
+	return 0;
+}
+
+/*
+ * @brief Print what the replay left behind
+ * @param[in] speed Speed of the replay
+ */
+static void _test_report(test_speed_e speed)
+{
+	unsigned int times[DATA_STATS_LEVEL_MAX + 1];
+	perf_activity_s activity;
+	int level = 0;
+	int best_score = 0;
+	int score = 0;
+	int count;
+	int played;
+	int i, n;
+	unsigned int total;
+
+	data_progress_get(&level, &best_score);
+	perf_activity_get(&activity);
+
+	printf("%s: replay %.1f ms, level %d, best score %d\n", test_speed_names[speed],
+			(s_info.replay_end - s_info.replay_start) * 1000.0, level, best_score);
+	printf("%s: taps %d, mean %.3f ms, max %.3f ms\n", test_speed_names[speed],
+			s_info.taps, s_info.taps ? s_info.tap_total * 1000.0 / s_info.taps : 0.0, s_info.tap_max * 1000.0);
+	printf("%s: frames %d, mean %.3f ms, max %.3f ms, stalls %d, wakeups %u\n", test_speed_names[speed],
+			s_info.frames, s_info.frames ? s_info.render_total * 1000.0 / s_info.frames : 0.0, s_info.render_max * 1000.0,
+			perf_stall_count_get(), activity.wakeups);
+	printf("%s: allocations of %d taps after the first game, max %lu, budget %lu of the status text, %d over it\n",
+			test_speed_names[speed], s_info.counted_taps, s_info.alloc_max, s_info.alloc_budget, s_info.over_budget);
+	if (s_info.over_budget)
+		s_info.failed = 1;
+
+	/* Runs are written by the writer thread, which data_finalize() has joined */
+	count = data_stats_run_count_get();
+	for (i = 0; i < count; i++) {
+		n = data_stats_run_get(i, &score, times, DATA_STATS_LEVEL_MAX + 1);
+		if (n < 0) {
+			printf("%s: run %d is corrupted\n", test_speed_names[speed], i + 1);
+			s_info.failed = 1;
+			continue;
+		}
+
+		played = 0;
+		total = 0;
+		while (--n > 0) {
+			if (times[n]) {
+				total += times[n];
+				played++;
+			}
+		}
+		printf("%s: run %d score %d, mean reaction %u ms over %d levels\n", test_speed_names[speed],
+				i + 1, score, played ? total / played : 0, played);
+	}
+}
+
+/*
+ * @brief Remove a file of the data directory, called by nftw()
+ * @param[in] path Path of the file
+ * @param[in] st Status of the file
+ * @param[in] flag Type of the file
+ * @param[in] ftw Level of the file in the tree
+ */
+static int _test_remove_cb(const char *path, const struct stat *st, int flag, struct FTW *ftw)
+{
+	return remove(path);
+}
+
+/*
+ * @brief Replay the trace once in this process
+ * @param[in] speed Speed of the replay
+ * @param[in] argc Count of the arguments
+ * @param[in] argv Arguments
+ */
+static int _test_replay(test_speed_e speed, int argc, char *argv[])
+{
+	snprintf(s_info.data_path, sizeof(s_info.data_path), "/tmp/view_replay_test.XXXXXX");
+	if (mkdtemp(s_info.data_path) == NULL) {
+		perror("mkdtemp");
+		return 2;
+	}
+	strcat(s_info.data_path, "/");
+
+	/* No display on the host, the window renders into a buffer */
+	setenv("ELM_ENGINE", "buffer", 1);
+	elm_init(argc, argv);
+
+	if (_test_app_create()) {
+		fprintf(stderr, "failed to create the view\n");
+		s_info.failed = 1;
+	} else {
+		ecore_idler_add(_test_start_cb, (void *)(intptr_t)speed);
+		elm_run();
+	}
+
+	if (s_info.poll)
+		ecore_timer_del(s_info.poll);
+
+	feedback_stop();
+	reaction_stop();
+	view_destroy();
+	data_finalize();
+
+	/* Reopened to read back what the writer thread wrote */
+	if (s_info.replay_start > 0.0) {
+		data_initialize();
+		_test_report(speed);
+		data_finalize();
+	}
+
+	elm_shutdown();
+	nftw(s_info.data_path, _test_remove_cb, 8, FTW_DEPTH | FTW_PHYS);
+
+	return s_info.failed;
+}
+
+int main(int argc, char *argv[])
+{
+	test_speed_e first = TEST_SPEED_ORIGINAL;
+	test_speed_e last = TEST_SPEED_MAX;
+	test_speed_e speed;
+	int failed = 0;
+	int status;
+	int opt;
+	pid_t pid;
+
+	while ((opt = getopt(argc, argv, "s:v")) != -1) {
+		switch (opt) {
+		case 's':
+			first = last = strcmp(optarg, "max") ? TEST_SPEED_ORIGINAL : TEST_SPEED_MAX;
+			break;
+		case 'v':
+			s_info.verbose = 1;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-s original|max] [-v] res/ trace\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (optind != argc - 2) {
+		fprintf(stderr, "usage: %s [-s original|max] [-v] res/ trace\n", argv[0]);
+		return 2;
+	}
+
+	/* Paths of the app end with a slash */
+	snprintf(s_info.res_path, sizeof(s_info.res_path), "%s%s", argv[optind],
+			argv[optind][strlen(argv[optind]) - 1] == '/' ? "" : "/");
+	s_info.trace_path = argv[optind + 1];
+
+	/* Every speed starts from a fresh process, as the app does after a launch */
+	for (speed = first; speed <= last; speed++) {
+		fflush(stdout);
+		pid = fork();
+		if (pid < 0) {
+			perror("fork");
+			return 2;
+		}
+		if (pid == 0)
+			return _test_replay(speed, argc, argv);
+
+		if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status))
+			failed = 1;
+	}
+
+	return failed;
+}
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Status string catalog compiler on a plain Linux host.
+ * A source has one "key = text" line per string of CATALOG_STRINGS in inc/catalog.h, '#' starts a comment.
+ * Numbers go to "{0}" and "{1}", every string must use the same slots as the built-in English text.
+ * Text is escaped for the entry markup here, the app copies it as it is.
+ *
+ * Build:
+ *   gcc -O2 -Iinc tools/catalog_compile.c -o catalog_compile
+ *
+ * Run:
+ *   ./catalog_compile tools/locale/ko.txt res/locale/ko.cat
+ * The output has the byte order of the host, every supported device is little endian.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "catalog.h"
+
+#define LINE_MAX_LEN 1024
+#define TEXT_MAX_LEN 4096
+
+static const char *s_keys[CATALOG_STR_COUNT] = {
+#define CATALOG_KEY(id, key, text) key,
+	CATALOG_STRINGS(CATALOG_KEY)
+#undef CATALOG_KEY
+};
+
+static const char *s_builtin[CATALOG_STR_COUNT] = {
+#define CATALOG_TEXT(id, key, text) text,
+	CATALOG_STRINGS(CATALOG_TEXT)
+#undef CATALOG_TEXT
+};
+
+static struct compile_info {
+	char *text[CATALOG_STR_COUNT];
+	int length[CATALOG_STR_COUNT];
+	int slots[CATALOG_STR_COUNT];
+} s_info;
+
+/*
+ * @brief Get bit mask of the slots used by compiled text
+ * @param[in] text Compiled text
+ */
+static int _slot_mask(const char *text)
+{
+	int mask = 0;
+
+	for (; *text; text++) {
+		if (*text == CATALOG_SLOT && text[1]) {
+			mask |= 1 << (text[1] - '0');
+			text++;
+		}
+	}
+
+	return mask;
+}
+
+/*
+ * @brief Compile source text, escape markup and turn "{n}" into a slot
+ * @param[in] src Source text
+ * @param[out] out Compiled text
+ * @param[in] len Size of the output
+ * Returns length of the compiled text, -1 on error
+ */
+static int _compile_text(const char *src, char *out, int len)
+{
+	const char *escaped = NULL;
+	int used = 0;
+	int n;
+
+	for (; *src; src++) {
+		escaped = NULL;
+		if (*src == '&')
+			escaped = "&amp;";
+		else if (*src == '<')
+			escaped = "&lt;";
+		else if (*src == '>')
+			escaped = "&gt;";
+
+		if (escaped) {
+			n = (int)strlen(escaped);
+			if (used + n >= len)
+				return -1;
+			memcpy(out + used, escaped, n);
+			used += n;
+			continue;
+		}
+
+		if (*src == '{') {
+			if (!isdigit((unsigned char)src[1]) || src[2] != '}' || src[1] - '0' >= CATALOG_ARGS_MAX)
+				return -1;
+			if (used + 2 >= len)
+				return -1;
+			out[used++] = CATALOG_SLOT;
+			out[used++] = src[1];
+			src += 2;
+			continue;
+		}
+
+		if ((unsigned char)*src < ' ' || used + 1 >= len)
+			return -1;
+		out[used++] = *src;
+	}
+
+	out[used] = '\0';
+
+	return used;
+}
+
+/*
+ * @brief Trim white space at both ends in place
+ * @param[in] str String to be trimmed
+ */
+static char *_trim(char *str)
+{
+	char *end = NULL;
+
+	while (isspace((unsigned char)*str))
+		str++;
+
+	end = str + strlen(str);
+	while (end > str && isspace((unsigned char)end[-1]))
+		end--;
+	*end = '\0';
+
+	return str;
+}
+
+/*
+ * @brief Read every string of the source
+ * @param[in] path Path of the source
+ */
+static int _read_source(const char *path)
+{
+	char line[LINE_MAX_LEN];
+	char text[TEXT_MAX_LEN];
+	char *key = NULL;
+	char *value = NULL;
+	char *eq = NULL;
+	FILE *fp = NULL;
+	int lineno = 0;
+	int failed = 0;
+	int i;
+
+	fp = fopen(path, "r");
+	if (fp == NULL) {
+		perror(path);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), fp)) {
+		lineno++;
+		key = _trim(line);
+		if (*key == '\0' || *key == '#')
+			continue;
+
+		eq = strchr(key, '=');
+		if (eq == NULL) {
+			fprintf(stderr, "%s:%d: missing '='\n", path, lineno);
+			failed = 1;
+			continue;
+		}
+		*eq = '\0';
+		key = _trim(key);
+		value = _trim(eq + 1);
+
+		for (i = 0; i < CATALOG_STR_COUNT; i++)
+			if (!strcmp(key, s_keys[i]))
+				break;
+
+		if (i == CATALOG_STR_COUNT) {
+			fprintf(stderr, "%s:%d: unknown key '%s'\n", path, lineno, key);
+			failed = 1;
+		} else if (s_info.text[i]) {
+			fprintf(stderr, "%s:%d: duplicate key '%s'\n", path, lineno, key);
+			failed = 1;
+		} else if ((s_info.length[i] = _compile_text(value, text, sizeof(text))) < 0) {
+			fprintf(stderr, "%s:%d: bad text of '%s'\n", path, lineno, key);
+			failed = 1;
+		} else if ((s_info.slots[i] = _slot_mask(text)) != _slot_mask(s_builtin[i])) {
+			fprintf(stderr, "%s:%d: '%s' must use the numbers of \"%s\"\n", path, lineno, key, s_builtin[i]);
+			failed = 1;
+		} else {
+			s_info.text[i] = strdup(text);
+		}
+	}
+
+	fclose(fp);
+
+	for (i = 0; i < CATALOG_STR_COUNT; i++) {
+		if (s_info.text[i] == NULL && !failed) {
+			fprintf(stderr, "%s: missing key '%s'\n", path, s_keys[i]);
+			failed = 1;
+		}
+	}
+
+	return failed ? -1 : 0;
+}
+
+/*
+ * @brief Write the compiled catalog
+ * @param[in] path Path of the output
+ */
+static int _write_catalog(const char *path)
+{
+	catalog_header_s header = {
+		.magic = CATALOG_MAGIC,
+		.version = CATALOG_VERSION,
+		.count = CATALOG_STR_COUNT,
+	};
+	catalog_entry_s entry[CATALOG_STR_COUNT];
+	unsigned int offset = sizeof(header) + sizeof(entry);
+	FILE *fp = NULL;
+	int i;
+
+	for (i = 0; i < CATALOG_STR_COUNT; i++) {
+		entry[i].offset = offset;
+		entry[i].length = (unsigned short)s_info.length[i];
+		entry[i].slots = (unsigned short)s_info.slots[i];
+		offset += s_info.length[i] + 1;
+	}
+
+	fp = fopen(path, "wb");
+	if (fp == NULL) {
+		perror(path);
+		return -1;
+	}
+
+	fwrite(&header, sizeof(header), 1, fp);
+	fwrite(entry, sizeof(entry), 1, fp);
+	for (i = 0; i < CATALOG_STR_COUNT; i++)
+		fwrite(s_info.text[i], s_info.length[i] + 1, 1, fp);
+
+	if (fclose(fp)) {
+		perror(path);
+		return -1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc != 3) {
+		fprintf(stderr, "usage: %s source.txt output.cat\n", argv[0]);
+		return 2;
+	}
+
+	if (_read_source(argv[1]) || _write_catalog(argv[2]))
+		return 1;
+
+	return 0;
+}
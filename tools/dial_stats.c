@@ -0,0 +1,492 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Touch session analytics on a plain Linux host.
+ * Touch traces are loaded into arrays of x and y and classified in batches with the hit test of the app,
+ * so the sectors are the ones the player got. Per sector it reports presses, presses cancelled by sliding
+ * into another sector, and how far from the sector centre the presses land. The sector at touch down
+ * against the sector at lift shows where fingers drift, the answer against the tapped sector from
+ * reaction.csv shows which neighbours players confuse.
+ *
+ * Build:
+ *   gcc -O2 -march=native -Iinc tools/dial_stats.c src/dial.c src/trace.c -lm -o dial_stats
+ *
+ * Run:
+ *   ./dial_stats [-r reaction.csv] [-H heat.csv] [-b points] touch.trace ...
+ * -H writes the polar heatmaps as "ring,angle_bin,downs,cancels" lines, ring of DIAL_HEAT_RADIUS_STEP pixels
+ * and angle bin of 360 / DIAL_HEAT_ANGLE_BINS degrees clockwise from the left edge of sector 0.
+ * -b classifies the given number of random points and reports throughput.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "trace.h"
+#include "dial.h"
+
+#define LINE_MAX_LEN 256
+
+/* Touch events of all traces, one array per field */
+typedef struct {
+	int *x;
+	int *y;
+	unsigned char *type;
+	signed char *sector;
+	int count;
+	int size;
+} points_s;
+
+/* Presses, one per touch down with its lift */
+typedef struct {
+	int *x;
+	int *y;
+	signed char *down;
+	signed char *up;
+	unsigned char *cancelled;
+	int count;
+} presses_s;
+
+static struct stats_info {
+	points_s points;
+	presses_s presses;
+	int *cancel_x;
+	int *cancel_y;
+	int cancel_count;
+	dial_heat_s heat_down;
+	dial_heat_s heat_cancel;
+	dial_confusion_s drift;
+	dial_confusion_s answer;
+	int answer_count;
+	int event_count;
+} s_info = {
+	.points = { NULL, },
+	.presses = { NULL, },
+	.cancel_x = NULL,
+	.cancel_y = NULL,
+	.cancel_count = 0,
+	.answer_count = 0,
+	.event_count = 0,
+};
+
+static double _time_get(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/*
+ * @brief Make room for one more event
+ * @param[in,out] points Events
+ */
+static int _points_grow(points_s *points)
+{
+	int size = points->size ? points->size * 2 : 4096;
+	int *x, *y;
+	unsigned char *type;
+
+	if (points->count < points->size)
+		return 0;
+
+	x = realloc(points->x, size * sizeof(*x));
+	if (x == NULL)
+		return -1;
+	points->x = x;
+
+	y = realloc(points->y, size * sizeof(*y));
+	if (y == NULL)
+		return -1;
+	points->y = y;
+
+	type = realloc(points->type, size);
+	if (type == NULL)
+		return -1;
+	points->type = type;
+
+	points->size = size;
+
+	return 0;
+}
+
+/*
+ * @brief Append the events of a trace file
+ * @param[in] path Path of the trace file
+ */
+static int _trace_load(const char *path)
+{
+	points_s *points = &s_info.points;
+	trace_reader_s reader;
+	trace_event_s ev;
+	int ret;
+
+	if (trace_reader_open(&reader, path)) {
+		fprintf(stderr, "%s: cannot open trace\n", path);
+		return -1;
+	}
+
+	while ((ret = trace_reader_next(&reader, &ev)) == 1) {
+		if (_points_grow(points)) {
+			trace_reader_close(&reader);
+			return -1;
+		}
+		points->x[points->count] = ev.x;
+		points->y[points->count] = ev.y;
+		points->type[points->count] = (unsigned char)ev.type;
+		points->count++;
+		s_info.event_count++;
+	}
+	trace_reader_close(&reader);
+
+	if (ret < 0)
+		fprintf(stderr, "%s: broken trace, using the events before the break\n", path);
+
+	/* A press open at the end of one trace is not continued by the next */
+	if (_points_grow(points))
+		return -1;
+	points->x[points->count] = 0;
+	points->y[points->count] = 0;
+	points->type[points->count] = TRACE_EVENT_UP;
+	points->count++;
+
+	return 0;
+}
+
+/*
+ * @brief Split the classified events into presses the way the view handles them
+ * A move into another sector cancels the press, nothing is tapped when it lifts
+ */
+static int _presses_build(void)
+{
+	points_s *points = &s_info.points;
+	presses_s *presses = &s_info.presses;
+	int down = -1;
+	int cancelled = 0;
+	int i;
+
+	presses->x = malloc(points->count * sizeof(int));
+	presses->y = malloc(points->count * sizeof(int));
+	presses->down = malloc(points->count);
+	presses->up = malloc(points->count);
+	presses->cancelled = malloc(points->count);
+	s_info.cancel_x = malloc(points->count * sizeof(int));
+	s_info.cancel_y = malloc(points->count * sizeof(int));
+	if (presses->x == NULL || presses->y == NULL || presses->down == NULL || presses->up == NULL
+			|| presses->cancelled == NULL || s_info.cancel_x == NULL || s_info.cancel_y == NULL)
+		return -1;
+
+	for (i = 0; i < points->count; i++) {
+		switch (points->type[i]) {
+		case TRACE_EVENT_DOWN:
+			down = i;
+			cancelled = 0;
+			break;
+		case TRACE_EVENT_MOVE:
+			if (down < 0 || cancelled || points->sector[down] == -1 || points->sector[i] == points->sector[down])
+				break;
+			cancelled = 1;
+			s_info.cancel_x[s_info.cancel_count] = points->x[i];
+			s_info.cancel_y[s_info.cancel_count] = points->y[i];
+			s_info.cancel_count++;
+			break;
+		default:
+			if (down < 0)
+				break;
+			presses->x[presses->count] = points->x[down];
+			presses->y[presses->count] = points->y[down];
+			presses->down[presses->count] = points->sector[down];
+			presses->up[presses->count] = points->sector[i];
+			presses->cancelled[presses->count] = (unsigned char)cancelled;
+			presses->count++;
+			down = -1;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Count the answer against the tapped sector of every sample in reaction.csv
+ * @param[in] path Path of reaction.csv
+ */
+static int _reaction_load(const char *path)
+{
+	char line[LINE_MAX_LEN];
+	signed char answer[DIAL_BATCH_CHUNK];
+	signed char tapped[DIAL_BATCH_CHUNK];
+	unsigned int level, a;
+	int t, n = 0;
+	long when;
+	FILE *fp = fopen(path, "r");
+
+	if (fp == NULL) {
+		fprintf(stderr, "%s: cannot open\n", path);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), fp)) {
+		if (sscanf(line, "%ld,%u,%u,%d,", &when, &level, &a, &t) != 4
+				|| a >= DIAL_SECTOR_COUNT || t < -1 || t >= DIAL_SECTOR_COUNT)
+			continue;
+
+		answer[n] = (signed char)a;
+		tapped[n] = (signed char)t;
+		if (++n == DIAL_BATCH_CHUNK) {
+			dial_confusion_add(&s_info.answer, answer, tapped, n);
+			s_info.answer_count += n;
+			n = 0;
+		}
+	}
+	dial_confusion_add(&s_info.answer, answer, tapped, n);
+	s_info.answer_count += n;
+	fclose(fp);
+
+	return 0;
+}
+
+/*
+ * @brief Print a confusion matrix, "-" is no sector
+ * @param[in] title Title of the matrix
+ * @param[in] confusion Confusion matrix
+ */
+static void _confusion_print(const char *title, const dial_confusion_s *confusion)
+{
+	int r, c;
+
+	printf("\n# %s\n#     ", title);
+	for (c = 0; c <= DIAL_SECTOR_COUNT; c++) {
+		if (c)
+			printf("%7d", c - 1);
+		else
+			printf("%7s", "-");
+	}
+	printf("\n");
+
+	for (r = 0; r <= DIAL_SECTOR_COUNT; r++) {
+		if (r)
+			printf("%6d", r - 1);
+		else
+			printf("%6s", "-");
+		for (c = 0; c <= DIAL_SECTOR_COUNT; c++)
+			printf("%7u", confusion->cells[r][c]);
+		printf("\n");
+	}
+}
+
+/*
+ * @brief Print presses per sector, cancels, and the spread of touch down across the sector
+ * Spread is counted on the rings fully outside RADIUS_MIN, edge rate is the share in the outer bin on either side
+ */
+static void _sectors_print(void)
+{
+	unsigned long long spread[DIAL_SECTOR_COUNT][DIAL_HEAT_SECTOR_BINS];
+	unsigned long long total, edge;
+	unsigned int pressed[DIAL_SECTOR_COUNT];
+	unsigned int cancelled[DIAL_SECTOR_COUNT];
+	int ring_min = (RADIUS_MIN + DIAL_HEAT_RADIUS_STEP - 1) / DIAL_HEAT_RADIUS_STEP;
+	int ring, bin, s, k;
+
+	memset(spread, 0, sizeof(spread));
+	memset(pressed, 0, sizeof(pressed));
+	memset(cancelled, 0, sizeof(cancelled));
+
+	for (ring = ring_min; ring < DIAL_HEAT_RADIUS_BINS; ring++)
+		for (bin = 0; bin < DIAL_HEAT_ANGLE_BINS; bin++)
+			spread[bin / DIAL_HEAT_SECTOR_BINS][bin % DIAL_HEAT_SECTOR_BINS] += s_info.heat_down.bins[ring][bin];
+
+	for (k = 0; k < s_info.presses.count; k++) {
+		s = s_info.presses.down[k];
+		if (s < 0)
+			continue;
+		pressed[s]++;
+		cancelled[s] += s_info.presses.cancelled[k];
+	}
+
+	printf("\n# sector presses cancelled cancel_rate edge_rate spread(%d degree bins from the left edge)\n",
+			360 / DIAL_HEAT_ANGLE_BINS);
+	for (s = 0; s < DIAL_SECTOR_COUNT; s++) {
+		total = 0;
+		for (k = 0; k < DIAL_HEAT_SECTOR_BINS; k++)
+			total += spread[s][k];
+		edge = spread[s][0] + spread[s][DIAL_HEAT_SECTOR_BINS - 1];
+
+		printf("%8d %7u %9u %11.3f %9.3f ", s, pressed[s], cancelled[s],
+				pressed[s] ? (double)cancelled[s] / pressed[s] : 0.0, total ? (double)edge / total : 0.0);
+		for (k = 0; k < DIAL_HEAT_SECTOR_BINS; k++)
+			printf(" %llu", spread[s][k]);
+		printf("\n");
+	}
+}
+
+/*
+ * @brief Write the heatmaps of touch down and of cancels
+ * @param[in] path Path of the CSV file
+ */
+static int _heat_write(const char *path)
+{
+	FILE *fp = fopen(path, "w");
+	int ring, bin;
+
+	if (fp == NULL) {
+		fprintf(stderr, "%s: cannot create\n", path);
+		return -1;
+	}
+
+	fprintf(fp, "ring,angle_bin,downs,cancels\n");
+	for (ring = 0; ring < DIAL_HEAT_RADIUS_BINS; ring++)
+		for (bin = 0; bin < DIAL_HEAT_ANGLE_BINS; bin++)
+			if (s_info.heat_down.bins[ring][bin] || s_info.heat_cancel.bins[ring][bin])
+				fprintf(fp, "%d,%d,%u,%u\n", ring, bin, s_info.heat_down.bins[ring][bin], s_info.heat_cancel.bins[ring][bin]);
+
+	return fclose(fp) ? -1 : 0;
+}
+
+/*
+ * @brief Classify random points on the screen and report throughput
+ * @param[in] count Number of points
+ */
+static int _bench(int count)
+{
+	dial_heat_s *heat = calloc(1, sizeof(*heat));
+	int *x = malloc(count * sizeof(int));
+	int *y = malloc(count * sizeof(int));
+	signed char *sector = malloc(count);
+	unsigned int seed = 1;
+	unsigned int hits = 0;
+	double start, sector_time, heat_time;
+	int i;
+
+	if (heat == NULL || x == NULL || y == NULL || sector == NULL) {
+		free(heat);
+		free(x);
+		free(y);
+		free(sector);
+		return -1;
+	}
+
+	for (i = 0; i < count; i++) {
+		seed = seed * 1103515245 + 12345;
+		x[i] = (seed >> 8) % (2 * CENTER_REF_X);
+		seed = seed * 1103515245 + 12345;
+		y[i] = (seed >> 8) % (2 * CENTER_REF_Y);
+	}
+
+	start = _time_get();
+	dial_sector_batch(x, y, sector, count);
+	sector_time = _time_get() - start;
+
+	start = _time_get();
+	dial_heat_add(heat, x, y, count);
+	heat_time = _time_get() - start;
+
+	/* Keeps the classification from being dropped */
+	for (i = 0; i < count; i++)
+		hits += sector[i] >= 0;
+
+	printf("# bench points %d on_dial %u sector %.1f Mpoints/s heatmap %.1f Mpoints/s\n", count, hits,
+			count / sector_time / 1000000.0, count / heat_time / 1000000.0);
+
+	free(heat);
+	free(x);
+	free(y);
+	free(sector);
+
+	return 0;
+}
+
+static void _usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-r reaction.csv] [-H heat.csv] [-b points] touch.trace ...\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *reaction_path = NULL;
+	const char *heat_path = NULL;
+	points_s *points = &s_info.points;
+	double start;
+	int bench = 0;
+	int failed = 0;
+	int opt;
+	int i;
+
+	while ((opt = getopt(argc, argv, "r:H:b:h")) != -1) {
+		switch (opt) {
+		case 'r':
+			reaction_path = optarg;
+			break;
+		case 'H':
+			heat_path = optarg;
+			break;
+		case 'b':
+			bench = atoi(optarg);
+			break;
+		default:
+			_usage(argv[0]);
+			return 2;
+		}
+	}
+
+	if (optind >= argc && bench <= 0) {
+		_usage(argv[0]);
+		return 2;
+	}
+
+	if (bench > 0 && _bench(bench))
+		return 2;
+
+	if (optind >= argc)
+		return 0;
+
+	for (i = optind; i < argc; i++)
+		if (_trace_load(argv[i]))
+			failed = 1;
+
+	points->sector = malloc(points->count ? points->count : 1);
+	if (points->sector == NULL)
+		return 2;
+
+	start = _time_get();
+	dial_sector_batch(points->x, points->y, points->sector, points->count);
+	if (_presses_build())
+		return 2;
+	dial_heat_add(&s_info.heat_down, s_info.presses.x, s_info.presses.y, s_info.presses.count);
+	dial_heat_add(&s_info.heat_cancel, s_info.cancel_x, s_info.cancel_y, s_info.cancel_count);
+	dial_confusion_add(&s_info.drift, s_info.presses.down, s_info.presses.up, s_info.presses.count);
+
+	printf("# events %d presses %d cancelled %d in %.3f ms\n", s_info.event_count, s_info.presses.count,
+			s_info.cancel_count, (_time_get() - start) * 1000.0);
+
+	_sectors_print();
+	_confusion_print("sector at touch down (row) against sector at lift (column)", &s_info.drift);
+
+	if (reaction_path) {
+		if (_reaction_load(reaction_path))
+			failed = 1;
+		else
+			_confusion_print("answer (row) against tapped sector (column)", &s_info.answer);
+	}
+
+	if (heat_path && _heat_write(heat_path))
+		failed = 1;
+
+	return failed;
+}
@@ -0,0 +1,743 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * EDC dead part elimination on a plain Linux host.
+ * Parts named "sw.*" are set from C, they are kept only if their name is a string literal of the C sources.
+ * Other parts are layout and decoration and are kept, like every part a kept part is positioned against.
+ * A program is kept if C emits its signal, or if its built-in signal comes from a kept part, and so is its "after" chain.
+ * A clip_to to a removed part is dropped, images are kept only if a kept part shows them.
+ *
+ * Build:
+ *   gcc -O2 tools/edc_prune.c -o edc_prune
+ *
+ * Run:
+ *   ./edc_prune [-o pruned.edc] [-r res/images] res/edje/main.edc $(find src -name '*.c')
+ * Everything removed is reported on stderr, -o writes the pruned EDC.
+ * -r reports files of the directory no C string literal names.
+ * Exit status is 1 if anything can be removed, so it can guard the build.
+ */
+
+#include <ctype.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NAME_MAX_LEN 128
+
+/* Statement of EDC, "key: values;" or "key { children }" */
+struct stmt {
+	char key[NAME_MAX_LEN];
+	/* First string value, e.g. the name of "name: \"bg\";" */
+	char value[NAME_MAX_LEN];
+	int start;
+	int end;
+	int parent;
+	int block;
+};
+
+struct part {
+	int stmt;
+	int group;
+	char name[NAME_MAX_LEN];
+	int live;
+};
+
+struct program {
+	int stmt;
+	int group;
+	char name[NAME_MAX_LEN];
+	char signal[NAME_MAX_LEN];
+	char source[NAME_MAX_LEN];
+	int live;
+};
+
+struct image {
+	int stmt;
+	char name[NAME_MAX_LEN];
+	int live;
+};
+
+struct range {
+	int start;
+	int end;
+};
+
+static struct prune_info {
+	char *edc;
+	int len;
+
+	struct stmt *stmts;
+	int stmt_count;
+
+	struct part *parts;
+	int part_count;
+	struct program *programs;
+	int program_count;
+	struct image *images;
+	int image_count;
+
+	/* String literals of the C sources */
+	char **strings;
+	int string_count;
+
+	struct range *cuts;
+	int cut_count;
+} s_info = {
+	.edc = NULL,
+	.len = 0,
+	.stmts = NULL,
+	.stmt_count = 0,
+	.parts = NULL,
+	.part_count = 0,
+	.programs = NULL,
+	.program_count = 0,
+	.images = NULL,
+	.image_count = 0,
+	.strings = NULL,
+	.string_count = 0,
+	.cuts = NULL,
+	.cut_count = 0,
+};
+
+/*
+ * @brief Grow an array by one element
+ * @param[in,out] array Array to be grown
+ * @param[in,out] count Number of elements
+ * @param[in] size Size of an element
+ * Returns the new element, zeroed
+ */
+static void *_grow(void *array, int *count, size_t size)
+{
+	void **ptr = array;
+	char *grown = realloc(*ptr, (*count + 1) * size);
+
+	if (grown == NULL) {
+		fprintf(stderr, "out of memory\n");
+		exit(2);
+	}
+
+	*ptr = grown;
+	memset(grown + *count * size, 0, size);
+
+	return grown + (*count)++ * size;
+}
+
+/*
+ * @brief Read a whole file
+ * @param[in] path Path of the file
+ * @param[out] len Length of the content
+ */
+static char *_read_file(const char *path, int *len)
+{
+	FILE *fp = fopen(path, "rb");
+	char *buf = NULL;
+	long size;
+
+	if (fp == NULL) {
+		perror(path);
+		return NULL;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	buf = malloc(size + 1);
+	if (buf == NULL || fread(buf, 1, size, fp) != (size_t)size) {
+		fclose(fp);
+		free(buf);
+		return NULL;
+	}
+
+	buf[size] = '\0';
+	*len = (int)size;
+	fclose(fp);
+
+	return buf;
+}
+
+/*
+ * @brief Collect every string literal of a C source, comments and character constants are skipped
+ * @param[in] path Path of the C source
+ */
+static int _read_c_strings(const char *path)
+{
+	char *src = NULL;
+	char **slot = NULL;
+	int len = 0;
+	int i, start;
+
+	src = _read_file(path, &len);
+	if (src == NULL)
+		return -1;
+
+	for (i = 0; i < len; i++) {
+		if (src[i] == '/' && src[i + 1] == '*') {
+			for (i += 2; i < len && !(src[i] == '*' && src[i + 1] == '/'); i++)
+				;
+			i++;
+		} else if (src[i] == '/' && src[i + 1] == '/') {
+			for (; i < len && src[i] != '\n'; i++)
+				;
+		} else if (src[i] == '\'') {
+			for (i++; i < len && src[i] != '\''; i++)
+				if (src[i] == '\\')
+					i++;
+		} else if (src[i] == '"') {
+			for (start = ++i; i < len && src[i] != '"'; i++)
+				if (src[i] == '\\')
+					i++;
+			slot = _grow(&s_info.strings, &s_info.string_count, sizeof(char *));
+			*slot = strndup(src + start, i - start);
+		}
+	}
+
+	free(src);
+
+	return 0;
+}
+
+/*
+ * @brief Check if the C sources have a string literal with the text
+ * @param[in] text Text to look for
+ * @param[in] substring 1 if the literal may only contain the text
+ */
+static int _c_has_string(const char *text, int substring)
+{
+	int i;
+
+	for (i = 0; i < s_info.string_count; i++) {
+		if (substring ? strstr(s_info.strings[i], text) != NULL : !strcmp(s_info.strings[i], text))
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Skip white space, comments and preprocessor lines
+ * @param[in] pos Position in the EDC
+ */
+static int _skip_space(int pos)
+{
+	const char *s = s_info.edc;
+
+	while (pos < s_info.len) {
+		if (isspace((unsigned char)s[pos])) {
+			pos++;
+		} else if (s[pos] == '/' && s[pos + 1] == '*') {
+			for (pos += 2; pos < s_info.len && !(s[pos] == '*' && s[pos + 1] == '/'); pos++)
+				;
+			pos += 2;
+		} else if ((s[pos] == '/' && s[pos + 1] == '/') || s[pos] == '#') {
+			for (; pos < s_info.len && s[pos] != '\n'; pos++)
+				;
+		} else {
+			break;
+		}
+	}
+
+	return pos;
+}
+
+/*
+ * @brief Parse statements up to the closing brace of the block
+ * @param[in] pos Position after the opening brace, or the start of the file
+ * @param[in] parent Statement of the block, -1 at the top
+ * Returns position after the closing brace
+ */
+static int _parse_block(int pos, int parent)
+{
+	const char *s = s_info.edc;
+	struct stmt *stmt = NULL;
+	int index, n, value_done;
+
+	for (;;) {
+		pos = _skip_space(pos);
+		if (pos >= s_info.len)
+			return pos;
+		if (s[pos] == '}')
+			return pos + 1;
+
+		stmt = _grow(&s_info.stmts, &s_info.stmt_count, sizeof(struct stmt));
+		index = s_info.stmt_count - 1;
+		stmt->start = pos;
+		stmt->parent = parent;
+
+		for (n = 0; pos < s_info.len && (isalnum((unsigned char)s[pos]) || s[pos] == '_' || s[pos] == '.'); pos++)
+			if (n < NAME_MAX_LEN - 1)
+				stmt->key[n++] = s[pos];
+
+		/* Values up to ';' or '{', the first string is kept */
+		value_done = 0;
+		while (pos < s_info.len && s[pos] != ';' && s[pos] != '{' && s[pos] != '}') {
+			if (s[pos] == '"') {
+				for (n = 0, pos++; pos < s_info.len && s[pos] != '"'; pos++)
+					if (!value_done && n < NAME_MAX_LEN - 1)
+						s_info.stmts[index].value[n++] = s[pos];
+				value_done = 1;
+			} else if (!value_done && !isspace((unsigned char)s[pos]) && s[pos] != ':') {
+				/* Unquoted value, e.g. "type: SWALLOW;" */
+				for (n = 0; pos < s_info.len && !isspace((unsigned char)s[pos]) && s[pos] != ';'; pos++)
+					if (n < NAME_MAX_LEN - 1)
+						s_info.stmts[index].value[n++] = s[pos];
+				value_done = 1;
+				continue;
+			}
+			pos++;
+		}
+
+		if (pos < s_info.len && s[pos] == '{') {
+			s_info.stmts[index].block = 1;
+			pos = _parse_block(pos + 1, index);
+			n = _skip_space(pos);
+			if (n < s_info.len && s[n] == ';')
+				pos = n + 1;
+		} else if (pos < s_info.len && s[pos] == ';') {
+			pos++;
+		}
+
+		s_info.stmts[index].end = pos;
+	}
+}
+
+/*
+ * @brief Find a child statement with the key
+ * @param[in] parent Parent statement
+ * @param[in] key Key to look for
+ * @param[in] from Index to continue from, -1 for the first
+ */
+static int _child_find(int parent, const char *key, int from)
+{
+	int i;
+
+	for (i = from < 0 ? parent + 1 : from + 1; i < s_info.stmt_count && s_info.stmts[i].start < s_info.stmts[parent].end; i++)
+		if (s_info.stmts[i].parent == parent && !strcmp(s_info.stmts[i].key, key))
+			return i;
+
+	return -1;
+}
+
+/*
+ * @brief Check if the statement is below the ancestor
+ * @param[in] stmt Statement
+ * @param[in] ancestor Ancestor statement
+ */
+static int _is_below(int stmt, int ancestor)
+{
+	for (stmt = s_info.stmts[stmt].parent; stmt >= 0; stmt = s_info.stmts[stmt].parent)
+		if (stmt == ancestor)
+			return 1;
+
+	return 0;
+}
+
+/*
+ * @brief Collect images, parts and programs of the parsed EDC
+ */
+static void _collect(void)
+{
+	struct part *part = NULL;
+	struct program *program = NULL;
+	struct image *image = NULL;
+	struct stmt *stmt = NULL;
+	int i, group, name;
+
+	for (i = 0; i < s_info.stmt_count; i++) {
+		stmt = &s_info.stmts[i];
+		if (stmt->parent < 0)
+			continue;
+
+		if (!strcmp(stmt->key, "image") && !stmt->block && !strcmp(s_info.stmts[stmt->parent].key, "images")) {
+			image = _grow(&s_info.images, &s_info.image_count, sizeof(struct image));
+			image->stmt = i;
+			snprintf(image->name, sizeof(image->name), "%s", stmt->value);
+			continue;
+		}
+
+		if (!stmt->block || (strcmp(stmt->key, "part") && strcmp(stmt->key, "program")))
+			continue;
+
+		for (group = stmt->parent; group >= 0 && strcmp(s_info.stmts[group].key, "group"); group = s_info.stmts[group].parent)
+			;
+		name = _child_find(i, "name", -1);
+		if (group < 0 || name < 0)
+			continue;
+
+		if (!strcmp(stmt->key, "part")) {
+			part = _grow(&s_info.parts, &s_info.part_count, sizeof(struct part));
+			part->stmt = i;
+			part->group = group;
+			snprintf(part->name, sizeof(part->name), "%s", s_info.stmts[name].value);
+		} else {
+			program = _grow(&s_info.programs, &s_info.program_count, sizeof(struct program));
+			program->stmt = i;
+			program->group = group;
+			snprintf(program->name, sizeof(program->name), "%s", s_info.stmts[name].value);
+			if ((name = _child_find(i, "signal", -1)) >= 0)
+				snprintf(program->signal, sizeof(program->signal), "%s", s_info.stmts[name].value);
+			if ((name = _child_find(i, "source", -1)) >= 0)
+				snprintf(program->source, sizeof(program->source), "%s", s_info.stmts[name].value);
+		}
+	}
+}
+
+/*
+ * @brief Find the part of the group by name
+ * @param[in] group Group statement
+ * @param[in] name Name of the part
+ */
+static struct part *_part_find(int group, const char *name)
+{
+	int i;
+
+	for (i = 0; i < s_info.part_count; i++)
+		if (s_info.parts[i].group == group && !strcmp(s_info.parts[i].name, name))
+			return &s_info.parts[i];
+
+	return NULL;
+}
+
+/*
+ * @brief Find the program of the group by name
+ * @param[in] group Group statement
+ * @param[in] name Name of the program
+ */
+static struct program *_program_find(int group, const char *name)
+{
+	int i;
+
+	for (i = 0; i < s_info.program_count; i++)
+		if (s_info.programs[i].group == group && !strcmp(s_info.programs[i].name, name))
+			return &s_info.programs[i];
+
+	return NULL;
+}
+
+/*
+ * @brief Check if the signal is emitted by edje itself rather than by C
+ * @param[in] signal Signal of a program
+ */
+static int _signal_builtin(const char *signal)
+{
+	static const char *prefixes[] = { "show", "hide", "load", "resize", "mouse,", "drag", "focus,", "program,", NULL };
+	int i;
+
+	for (i = 0; prefixes[i]; i++)
+		if (!strncmp(signal, prefixes[i], strlen(prefixes[i])))
+			return 1;
+
+	return 0;
+}
+
+/*
+ * @brief Mark every part and program which can be reached, until nothing changes
+ */
+static void _mark(void)
+{
+	struct part *part = NULL;
+	struct part *ref = NULL;
+	struct program *program = NULL;
+	struct program *after = NULL;
+	struct stmt *stmt = NULL;
+	int changed = 1;
+	int i, k;
+
+	for (i = 0; i < s_info.part_count; i++) {
+		part = &s_info.parts[i];
+		part->live = strncmp(part->name, "sw.", 3) || _c_has_string(part->name, 0);
+	}
+
+	for (i = 0; i < s_info.program_count; i++) {
+		program = &s_info.programs[i];
+		program->live = program->signal[0] && !_signal_builtin(program->signal) && _c_has_string(program->signal, 0);
+	}
+
+	while (changed) {
+		changed = 0;
+
+		for (i = 0; i < s_info.program_count; i++) {
+			program = &s_info.programs[i];
+			if (!program->live && _signal_builtin(program->signal)) {
+				ref = _part_find(program->group, program->source);
+				if (program->source[0] == '\0' || !strcmp(program->source, "*") || (ref && ref->live)) {
+					program->live = 1;
+					changed = 1;
+				}
+			}
+			if (!program->live)
+				continue;
+
+			/* Targets and the chain of the program are reached with it */
+			for (k = _child_find(program->stmt, "target", -1); k >= 0; k = _child_find(program->stmt, "target", k)) {
+				ref = _part_find(program->group, s_info.stmts[k].value);
+				if (ref && !ref->live) {
+					ref->live = 1;
+					changed = 1;
+				}
+			}
+			for (k = _child_find(program->stmt, "after", -1); k >= 0; k = _child_find(program->stmt, "after", k)) {
+				after = _program_find(program->group, s_info.stmts[k].value);
+				if (after && !after->live) {
+					after->live = 1;
+					changed = 1;
+				}
+			}
+		}
+
+		/* Parts a kept part is positioned against, clip_to does not keep its clipper */
+		for (i = 0; i < s_info.part_count; i++) {
+			part = &s_info.parts[i];
+			if (!part->live)
+				continue;
+
+			for (k = part->stmt + 1; k < s_info.stmt_count && s_info.stmts[k].start < s_info.stmts[part->stmt].end; k++) {
+				stmt = &s_info.stmts[k];
+				if (strcmp(stmt->key, "to") && strcmp(stmt->key, "to_x") && strcmp(stmt->key, "to_y") && strcmp(stmt->key, "confine"))
+					continue;
+
+				ref = _part_find(part->group, stmt->value);
+				if (ref && !ref->live) {
+					ref->live = 1;
+					changed = 1;
+				}
+			}
+		}
+	}
+
+	/* Images shown by kept parts */
+	for (i = 0; i < s_info.image_count; i++) {
+		for (k = 0; k < s_info.stmt_count; k++) {
+			stmt = &s_info.stmts[k];
+			if (strcmp(stmt->key, "image.normal") && strcmp(stmt->key, "normal") && strcmp(stmt->key, "image.tween")
+					&& strcmp(stmt->key, "tween"))
+				continue;
+			if (strcmp(stmt->value, s_info.images[i].name))
+				continue;
+
+			for (part = s_info.parts; part < s_info.parts + s_info.part_count; part++)
+				if (part->live && _is_below(k, part->stmt))
+					s_info.images[i].live = 1;
+		}
+	}
+}
+
+/*
+ * @brief Cut the whole lines of the statement, with the comment lines right above it
+ * @param[in] stmt Statement to be removed
+ */
+static void _cut(int stmt)
+{
+	const char *s = s_info.edc;
+	struct range *range = NULL;
+	int start = s_info.stmts[stmt].start;
+	int end = s_info.stmts[stmt].end;
+	int prev, p;
+
+	while (start > 0 && s[start - 1] != '\n')
+		start--;
+	while (end < s_info.len && s[end] != '\n')
+		end++;
+	if (end < s_info.len)
+		end++;
+
+	/* Comment lines right above belong to the statement */
+	for (;;) {
+		/* Text before the start of the line must end a comment */
+		for (p = start; p > 0 && isspace((unsigned char)s[p - 1]); p--)
+			;
+		if (p < 2 || s[p - 2] != '*' || s[p - 1] != '/')
+			break;
+		for (p -= 2; p > 0 && !(s[p - 1] == '/' && s[p] == '*'); p--)
+			;
+		if (p == 0)
+			break;
+
+		/* Comment must start its own line */
+		for (prev = p - 1; prev > 0 && s[prev - 1] != '\n' && isspace((unsigned char)s[prev - 1]); prev--)
+			;
+		if (prev > 0 && s[prev - 1] != '\n')
+			break;
+		start = prev;
+	}
+
+	range = _grow(&s_info.cuts, &s_info.cut_count, sizeof(struct range));
+	range->start = start;
+	range->end = end;
+}
+
+/*
+ * @brief Compare cuts by position
+ */
+static int _cut_cmp(const void *a, const void *b)
+{
+	return ((const struct range *)a)->start - ((const struct range *)b)->start;
+}
+
+/*
+ * @brief Report and cut every statement which is not reached
+ * Returns number of removed statements
+ */
+static int _report(void)
+{
+	struct part *part = NULL;
+	struct part *clipper = NULL;
+	int removed = 0;
+	int i, k;
+
+	for (i = 0; i < s_info.part_count; i++) {
+		part = &s_info.parts[i];
+		if (!part->live) {
+			fprintf(stderr, "part \"%s\": not set from C and nothing kept needs it\n", part->name);
+			_cut(part->stmt);
+			removed++;
+			continue;
+		}
+
+		k = _child_find(part->stmt, "clip_to", -1);
+		clipper = k >= 0 ? _part_find(part->group, s_info.stmts[k].value) : NULL;
+		if (clipper && !clipper->live) {
+			fprintf(stderr, "part \"%s\": clip_to \"%s\" is removed\n", part->name, clipper->name);
+			_cut(k);
+			removed++;
+		}
+	}
+
+	for (i = 0; i < s_info.program_count; i++) {
+		if (!s_info.programs[i].live) {
+			fprintf(stderr, "program \"%s\": signal \"%s\" is never emitted\n", s_info.programs[i].name, s_info.programs[i].signal);
+			_cut(s_info.programs[i].stmt);
+			removed++;
+		}
+	}
+
+	for (i = 0; i < s_info.image_count; i++) {
+		if (!s_info.images[i].live) {
+			fprintf(stderr, "image \"%s\": not shown by any part\n", s_info.images[i].name);
+			_cut(s_info.images[i].stmt);
+			removed++;
+		}
+	}
+
+	return removed;
+}
+
+/*
+ * @brief Write the EDC without the cut lines
+ * @param[in] path Path of the output
+ */
+static int _write_pruned(const char *path)
+{
+	FILE *fp = fopen(path, "wb");
+	int pos = 0;
+	int i;
+
+	if (fp == NULL) {
+		perror(path);
+		return -1;
+	}
+
+	qsort(s_info.cuts, s_info.cut_count, sizeof(struct range), _cut_cmp);
+	for (i = 0; i < s_info.cut_count; i++) {
+		/* A cut inside a removed part is already gone */
+		if (s_info.cuts[i].start < pos)
+			continue;
+		fwrite(s_info.edc + pos, 1, s_info.cuts[i].start - pos, fp);
+		pos = s_info.cuts[i].end;
+	}
+	fwrite(s_info.edc + pos, 1, s_info.len - pos, fp);
+
+	return fclose(fp) ? -1 : 0;
+}
+
+/*
+ * @brief Report files of the resource directory which no string literal names
+ * @param[in] dir Resource directory
+ * Returns number of unused files
+ */
+static int _report_resources(const char *dir)
+{
+	struct dirent *entry = NULL;
+	DIR *dp = opendir(dir);
+	int unused = 0;
+
+	if (dp == NULL) {
+		perror(dir);
+		return 0;
+	}
+
+	while ((entry = readdir(dp)) != NULL) {
+		if (entry->d_name[0] == '.' || _c_has_string(entry->d_name, 1))
+			continue;
+		fprintf(stderr, "file \"%s/%s\": not named by C\n", dir, entry->d_name);
+		unused++;
+	}
+
+	closedir(dp);
+
+	return unused;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *out = NULL;
+	const char *res_dir = NULL;
+	int removed = 0;
+	int opt, i;
+
+	while ((opt = getopt(argc, argv, "o:r:h")) != -1) {
+		switch (opt) {
+		case 'o':
+			out = optarg;
+			break;
+		case 'r':
+			res_dir = optarg;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-o pruned.edc] [-r res_dir] main.edc source.c ...\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (optind + 1 >= argc) {
+		fprintf(stderr, "usage: %s [-o pruned.edc] [-r res_dir] main.edc source.c ...\n", argv[0]);
+		return 2;
+	}
+
+	s_info.edc = _read_file(argv[optind], &s_info.len);
+	if (s_info.edc == NULL)
+		return 2;
+
+	for (i = optind + 1; i < argc; i++)
+		if (_read_c_strings(argv[i]))
+			return 2;
+
+	_parse_block(0, -1);
+	_collect();
+	_mark();
+	removed = _report();
+
+	if (res_dir)
+		removed += _report_resources(res_dir);
+
+	if (out && _write_pruned(out))
+		return 2;
+
+	return removed ? 1 : 0;
+}
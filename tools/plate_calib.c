@@ -0,0 +1,570 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Plate calibration on a plain Linux host.
+ * Every plate is converted to CIELAB, the odd sector (figure) is found against the median
+ * of all sectors (ground) and its contrast is measured per pixel. The sector given as answer
+ * must be the figure. Difficulty goes from 0 (obvious) to 100 (no visible figure).
+ *
+ * Build:
+ *   gcc -O2 -march=native tools/plate_calib.c -o plate_calib $(pkg-config --cflags --libs libpng) -lm
+ *
+ * Run:
+ *   ./plate_calib [-v] [-n repeat] tools/plates/lv1.png:2 tools/plates/lv2.png:0 ...
+ * The answer after the colon is optional, it is the .answer of level_data in src/view.c.
+ * -v prints the colour difference of every sector, -n scores every plate repeat times after decoding to measure throughput.
+ * Exit status is 1 if any plate does not show its figure in the answer sector.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <png.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+/* Plate geometry, same as the hit test in inc/dial.h, for a 360 x 360 plate */
+#define PLATE_REF_SIZE 360
+#define SECTOR_COUNT 10
+/* Only the inside of the coloured ring is sampled, away from the separators */
+#define SAMPLE_RADIUS_MIN 120
+#define SAMPLE_RADIUS_MAX 172
+#define SAMPLE_ANGLE_MARGIN 3.0
+/* Colour difference below which two colours look the same */
+#define JND_DE 1.0f
+
+struct plate {
+	const char *path;
+	int answer;
+	int w;
+	int h;
+	unsigned char *rgba;
+};
+
+struct score {
+	int figure;
+	float contrast;
+	float noise;
+	float runner_up;
+	float difficulty;
+	float sector_de[SECTOR_COUNT];
+};
+
+static struct calib_info {
+	/* Sampled pixels and their sectors for the current plate size */
+	int *samples;
+	signed char *sectors;
+	int sample_count;
+	int map_w;
+	int map_h;
+
+	/* Lab planes of the samples, padded to a multiple of 8 */
+	float *L;
+	float *A;
+	float *B;
+	float *dist;
+
+	float srgb_linear[256];
+	int verbose;
+} s_info = {
+	.samples = NULL,
+	.sectors = NULL,
+	.sample_count = 0,
+	.map_w = 0,
+	.map_h = 0,
+
+	.L = NULL,
+	.A = NULL,
+	.B = NULL,
+	.dist = NULL,
+
+	.verbose = 0,
+};
+
+static double _time_get(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/*
+ * @brief Decode the plate into RGBA
+ * @param[in,out] plate Plate with path set
+ */
+static int _plate_load(struct plate *plate)
+{
+	png_image image;
+
+	memset(&image, 0, sizeof(image));
+	image.version = PNG_IMAGE_VERSION;
+
+	if (!png_image_begin_read_from_file(&image, plate->path)) {
+		fprintf(stderr, "%s: %s\n", plate->path, image.message);
+		return -1;
+	}
+
+	image.format = PNG_FORMAT_RGBA;
+	plate->w = (int)image.width;
+	plate->h = (int)image.height;
+	plate->rgba = malloc(PNG_IMAGE_SIZE(image));
+	if (plate->rgba == NULL) {
+		png_image_free(&image);
+		return -1;
+	}
+
+	if (!png_image_finish_read(&image, NULL, plate->rgba, 0, NULL)) {
+		fprintf(stderr, "%s: %s\n", plate->path, image.message);
+		free(plate->rgba);
+		plate->rgba = NULL;
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Pick the sampled pixels for the plate size, sector i is centred at i * 36 degrees clockwise from the top
+ * Everything else (centre, separators, corners) is never converted
+ * @param[in] w Width of the plate
+ * @param[in] h Height of the plate
+ */
+static int _map_prepare(int w, int h)
+{
+	double scale = (double)(w < h ? w : h) / PLATE_REF_SIZE;
+	double r_min = SAMPLE_RADIUS_MIN * scale;
+	double r_max = SAMPLE_RADIUS_MAX * scale;
+	double step = 360.0 / SECTOR_COUNT;
+	double x, y, r, angle, offset;
+	int len = (w * h + 7) & ~7;
+	int i, j, sector;
+
+	if (s_info.samples && s_info.map_w == w && s_info.map_h == h)
+		return 0;
+
+	free(s_info.samples);
+	free(s_info.sectors);
+	free(s_info.L);
+	free(s_info.A);
+	free(s_info.B);
+	free(s_info.dist);
+
+	s_info.samples = malloc(len * sizeof(int));
+	s_info.sectors = malloc(len);
+	s_info.L = aligned_alloc(32, len * sizeof(float));
+	s_info.A = aligned_alloc(32, len * sizeof(float));
+	s_info.B = aligned_alloc(32, len * sizeof(float));
+	s_info.dist = aligned_alloc(32, len * sizeof(float));
+	if (!s_info.samples || !s_info.sectors || !s_info.L || !s_info.A || !s_info.B || !s_info.dist)
+		return -1;
+
+	s_info.map_w = w;
+	s_info.map_h = h;
+	s_info.sample_count = 0;
+
+	for (j = 0; j < h; j++) {
+		for (i = 0; i < w; i++) {
+			x = i + 0.5 - w / 2.0;
+			y = h / 2.0 - (j + 0.5);
+			r = sqrt(x * x + y * y);
+			if (r < r_min || r > r_max)
+				continue;
+
+			angle = atan2(x, y) * 180.0 / M_PI;
+			if (angle < 0.0)
+				angle += 360.0;
+
+			sector = (int)floor((angle + step / 2.0) / step) % SECTOR_COUNT;
+			offset = fabs(fmod(angle + step / 2.0, step) - step / 2.0);
+			if (step / 2.0 - offset < SAMPLE_ANGLE_MARGIN)
+				continue;
+
+			s_info.samples[s_info.sample_count] = j * w + i;
+			s_info.sectors[s_info.sample_count] = (signed char)sector;
+			s_info.sample_count++;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Lab companding function f(t) = cbrt(t) above the linear toe
+ */
+static inline float _lab_f(float t)
+{
+	return t > 0.008856f ? cbrtf(t) : 7.787f * t + 16.0f / 116.0f;
+}
+
+#if defined(__SSE2__)
+/*
+ * @brief Cube root of 4 positive floats, exponent division as guess and two Newton steps
+ */
+static inline __m128 _cbrt_ps(__m128 t)
+{
+	__m128i bits = _mm_castps_si128(t);
+	__m128 y;
+	__m128 third = _mm_set1_ps(1.0f / 3.0f);
+	__m128 two = _mm_set1_ps(2.0f);
+	int k;
+
+	/* bits / 3 done as a multiply on the float value of the integer, close enough for a guess */
+	bits = _mm_add_epi32(_mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(bits), third)), _mm_set1_epi32(0x2a514067));
+	y = _mm_castsi128_ps(bits);
+
+	for (k = 0; k < 2; k++)
+		y = _mm_mul_ps(third, _mm_add_ps(_mm_mul_ps(two, y), _mm_div_ps(t, _mm_mul_ps(y, y))));
+
+	return y;
+}
+
+/*
+ * @brief Lab companding of 4 values
+ */
+static inline __m128 _lab_f_ps(__m128 t)
+{
+	__m128 toe = _mm_add_ps(_mm_mul_ps(t, _mm_set1_ps(7.787f)), _mm_set1_ps(16.0f / 116.0f));
+	__m128 safe = _mm_max_ps(t, _mm_set1_ps(0.008856f));
+	__m128 above = _mm_cmpgt_ps(t, _mm_set1_ps(0.008856f));
+
+	return _mm_or_ps(_mm_and_ps(above, _cbrt_ps(safe)), _mm_andnot_ps(above, toe));
+}
+#endif
+
+/*
+ * @brief Convert sampled pixels to Lab planes, D65 white
+ * @param[in] rgba Pixels of the plate
+ */
+static void _lab_convert(const unsigned char *rgba)
+{
+	const float *lin = s_info.srgb_linear;
+	const unsigned char *px = NULL;
+	int n = s_info.sample_count;
+	int i = 0;
+
+#if defined(__SSE2__)
+	float r[4] __attribute__((aligned(16)));
+	float g[4] __attribute__((aligned(16)));
+	float b[4] __attribute__((aligned(16)));
+	__m128 R, G, B, X, Y, Z, fx, fy, fz;
+	int k;
+
+	for (; i + 4 <= n; i += 4) {
+		/* Gamma goes through the table, the rest is 4 pixels at a time */
+		for (k = 0; k < 4; k++) {
+			px = rgba + s_info.samples[i + k] * 4;
+			r[k] = lin[px[0]];
+			g[k] = lin[px[1]];
+			b[k] = lin[px[2]];
+		}
+		R = _mm_load_ps(r);
+		G = _mm_load_ps(g);
+		B = _mm_load_ps(b);
+
+		/* XYZ already divided by the white point */
+		X = _mm_add_ps(_mm_add_ps(_mm_mul_ps(R, _mm_set1_ps(0.4124f / 0.95047f)), _mm_mul_ps(G, _mm_set1_ps(0.3576f / 0.95047f))),
+				_mm_mul_ps(B, _mm_set1_ps(0.1805f / 0.95047f)));
+		Y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(R, _mm_set1_ps(0.2126f)), _mm_mul_ps(G, _mm_set1_ps(0.7152f))),
+				_mm_mul_ps(B, _mm_set1_ps(0.0722f)));
+		Z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(R, _mm_set1_ps(0.0193f / 1.08883f)), _mm_mul_ps(G, _mm_set1_ps(0.1192f / 1.08883f))),
+				_mm_mul_ps(B, _mm_set1_ps(0.9505f / 1.08883f)));
+
+		fx = _lab_f_ps(X);
+		fy = _lab_f_ps(Y);
+		fz = _lab_f_ps(Z);
+
+		_mm_store_ps(s_info.L + i, _mm_sub_ps(_mm_mul_ps(fy, _mm_set1_ps(116.0f)), _mm_set1_ps(16.0f)));
+		_mm_store_ps(s_info.A + i, _mm_mul_ps(_mm_sub_ps(fx, fy), _mm_set1_ps(500.0f)));
+		_mm_store_ps(s_info.B + i, _mm_mul_ps(_mm_sub_ps(fy, fz), _mm_set1_ps(200.0f)));
+	}
+#endif
+
+	for (; i < n; i++) {
+		float R = lin[rgba[s_info.samples[i] * 4]];
+		float G = lin[rgba[s_info.samples[i] * 4 + 1]];
+		float B = lin[rgba[s_info.samples[i] * 4 + 2]];
+		float fx = _lab_f((0.4124f * R + 0.3576f * G + 0.1805f * B) / 0.95047f);
+		float fy = _lab_f(0.2126f * R + 0.7152f * G + 0.0722f * B);
+		float fz = _lab_f((0.0193f * R + 0.1192f * G + 0.9505f * B) / 1.08883f);
+
+		s_info.L[i] = 116.0f * fy - 16.0f;
+		s_info.A[i] = 500.0f * (fx - fy);
+		s_info.B[i] = 200.0f * (fy - fz);
+	}
+}
+
+/*
+ * @brief Colour distance (CIE76 delta E) of every sample to the reference colour
+ * @param[in] ref Lab reference
+ */
+static void _distance_kernel(const float ref[3])
+{
+	int n = s_info.sample_count;
+	int i = 0;
+
+#if defined(__AVX__)
+	__m256 l8 = _mm256_set1_ps(ref[0]);
+	__m256 a8 = _mm256_set1_ps(ref[1]);
+	__m256 b8 = _mm256_set1_ps(ref[2]);
+	__m256 dl, da, db;
+
+	for (; i + 8 <= n; i += 8) {
+		dl = _mm256_sub_ps(_mm256_load_ps(s_info.L + i), l8);
+		da = _mm256_sub_ps(_mm256_load_ps(s_info.A + i), a8);
+		db = _mm256_sub_ps(_mm256_load_ps(s_info.B + i), b8);
+		_mm256_store_ps(s_info.dist + i, _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dl, dl), _mm256_mul_ps(da, da)), _mm256_mul_ps(db, db))));
+	}
+#elif defined(__SSE2__)
+	__m128 l4 = _mm_set1_ps(ref[0]);
+	__m128 a4 = _mm_set1_ps(ref[1]);
+	__m128 b4 = _mm_set1_ps(ref[2]);
+	__m128 dl, da, db;
+
+	for (; i + 4 <= n; i += 4) {
+		dl = _mm_sub_ps(_mm_load_ps(s_info.L + i), l4);
+		da = _mm_sub_ps(_mm_load_ps(s_info.A + i), a4);
+		db = _mm_sub_ps(_mm_load_ps(s_info.B + i), b4);
+		_mm_store_ps(s_info.dist + i, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dl, dl), _mm_mul_ps(da, da)), _mm_mul_ps(db, db))));
+	}
+#endif
+
+	for (; i < n; i++) {
+		float dl = s_info.L[i] - ref[0];
+		float da = s_info.A[i] - ref[1];
+		float db = s_info.B[i] - ref[2];
+
+		s_info.dist[i] = sqrtf(dl * dl + da * da + db * db);
+	}
+}
+
+static int _float_cmp(const void *a, const void *b)
+{
+	float x = *(const float *)a;
+	float y = *(const float *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/*
+ * @brief Median of the sector values of one Lab component
+ */
+static float _median(const float *values, int n)
+{
+	float sorted[SECTOR_COUNT];
+
+	memcpy(sorted, values, n * sizeof(float));
+	qsort(sorted, n, sizeof(float), _float_cmp);
+
+	return n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0f;
+}
+
+/*
+ * @brief Find the figure sector and measure its contrast against the ground
+ * @param[in] plate Decoded plate
+ * @param[out] score Result
+ */
+static int _plate_score(const struct plate *plate, struct score *score)
+{
+	double sum[SECTOR_COUNT][3];
+	double dist_sum[SECTOR_COUNT];
+	int count[SECTOR_COUNT];
+	float mean[3][SECTOR_COUNT];
+	float ground[3];
+	float *sector_de = score->sector_de;
+	double noise = 0.0;
+	int noise_count = 0;
+	int n;
+	int i, s, c;
+	float cnr;
+
+	if (_map_prepare(plate->w, plate->h))
+		return -1;
+
+	n = s_info.sample_count;
+	_lab_convert(plate->rgba);
+
+	memset(sum, 0, sizeof(sum));
+	memset(count, 0, sizeof(count));
+	for (i = 0; i < n; i++) {
+		s = s_info.sectors[i];
+		if (plate->rgba[s_info.samples[i] * 4 + 3] < 128)
+			continue;
+		sum[s][0] += s_info.L[i];
+		sum[s][1] += s_info.A[i];
+		sum[s][2] += s_info.B[i];
+		count[s]++;
+	}
+
+	for (s = 0; s < SECTOR_COUNT; s++) {
+		if (count[s] == 0) {
+			fprintf(stderr, "%s: sector %d is empty\n", plate->path, s);
+			return -1;
+		}
+		for (c = 0; c < 3; c++)
+			mean[c][s] = (float)(sum[s][c] / count[s]);
+	}
+
+	/* Figure is a single sector, the median of all sectors is the ground */
+	for (c = 0; c < 3; c++)
+		ground[c] = _median(mean[c], SECTOR_COUNT);
+
+	_distance_kernel(ground);
+
+	memset(dist_sum, 0, sizeof(dist_sum));
+	for (i = 0; i < n; i++) {
+		s = s_info.sectors[i];
+		if (plate->rgba[s_info.samples[i] * 4 + 3] < 128)
+			continue;
+		dist_sum[s] += s_info.dist[i];
+	}
+
+	score->figure = 0;
+	for (s = 0; s < SECTOR_COUNT; s++) {
+		sector_de[s] = (float)(dist_sum[s] / count[s]);
+		if (sector_de[s] > sector_de[score->figure])
+			score->figure = s;
+	}
+
+	score->runner_up = 0.0f;
+	for (s = 0; s < SECTOR_COUNT; s++) {
+		if (s == score->figure)
+			continue;
+		if (sector_de[s] > score->runner_up)
+			score->runner_up = sector_de[s];
+		noise += dist_sum[s];
+		noise_count += count[s];
+	}
+
+	score->contrast = sector_de[score->figure];
+	score->noise = noise_count ? (float)(noise / noise_count) : 0.0f;
+
+	/* Contrast over ground noise, with one just noticeable difference as the floor */
+	cnr = score->contrast / (score->noise + JND_DE);
+	score->difficulty = 100.0f / (1.0f + cnr / 2.0f);
+
+	return 0;
+}
+
+static void _usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-v] [-n repeat] plate.png[:answer] ...\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+	struct plate *plates = NULL;
+	struct score score;
+	char *colon = NULL;
+	double start;
+	int repeat = 0;
+	int count = 0;
+	int failed = 0;
+	int opt;
+	int i, k;
+
+	while ((opt = getopt(argc, argv, "n:vh")) != -1) {
+		switch (opt) {
+		case 'n':
+			repeat = atoi(optarg);
+			break;
+		case 'v':
+			s_info.verbose = 1;
+			break;
+		default:
+			_usage(argv[0]);
+			return 2;
+		}
+	}
+
+	if (optind >= argc) {
+		_usage(argv[0]);
+		return 2;
+	}
+
+	for (i = 0; i < 256; i++) {
+		float c = i / 255.0f;
+		s_info.srgb_linear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+	}
+
+	plates = calloc(argc - optind, sizeof(*plates));
+	if (plates == NULL)
+		return 2;
+
+	for (i = optind; i < argc; i++) {
+		struct plate *plate = &plates[count];
+
+		plate->path = argv[i];
+		plate->answer = -1;
+		colon = strrchr(argv[i], ':');
+		if (colon) {
+			*colon = '\0';
+			plate->answer = atoi(colon + 1);
+		}
+
+		if (_plate_load(plate)) {
+			failed = 1;
+			continue;
+		}
+		count++;
+	}
+
+	printf("# plate answer figure contrast_de noise_de runner_up_de difficulty\n");
+	for (i = 0; i < count; i++) {
+		if (_plate_score(&plates[i], &score)) {
+			failed = 1;
+			continue;
+		}
+
+		printf("%s %d %d %.2f %.2f %.2f %.1f%s\n", plates[i].path, plates[i].answer, score.figure,
+				score.contrast, score.noise, score.runner_up, score.difficulty,
+				plates[i].answer >= 0 && plates[i].answer != score.figure ? " MISMATCH" : "");
+
+		if (plates[i].answer >= 0 && plates[i].answer != score.figure)
+			failed = 1;
+
+		if (s_info.verbose) {
+			printf("#  sector_de");
+			for (k = 0; k < SECTOR_COUNT; k++)
+				printf(" %.2f", score.sector_de[k]);
+			printf("\n");
+		}
+	}
+
+	if (repeat > 0 && count > 0) {
+		start = _time_get();
+		for (k = 0; k < repeat; k++)
+			for (i = 0; i < count; i++)
+				_plate_score(&plates[i], &score);
+		printf("# %d plates scored in %.3f s, %.0f plates/s\n", repeat * count, _time_get() - start,
+				repeat * count / (_time_get() - start));
+	}
+
+	for (i = 0; i < count; i++)
+		free(plates[i].rgba);
+	free(plates);
+
+	return failed;
+}
@@ -0,0 +1,561 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.1 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://floralicense.org/license/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */ 
+
+/*
+ * Indexed plate converter on a plain Linux host, see inc/plate.h for the format.
+ * Colours of the PNG are counted, the most frequent PLATE_COLOURS_MAX are kept and the rest
+ * go to the nearest kept colour. The largest error of that is reported, 0 is lossless.
+ * Every row is stored as runs of one palette index.
+ *
+ * Build:
+ *   gcc -O2 -march=native -Iinc tools/plate_index.c src/plate.c -o plate_index $(pkg-config --cflags --libs libpng) -lm
+ *
+ * Run:
+ *   ./plate_index [-o plate.gip] [-r degrees] [-p variant.png] [-n repeat] plate.png
+ *   ./plate_index -o res/images/lv1.gip tools/plates/lv1.png
+ * Every plate of res/images has its source PNG in tools/plates.
+ * -r adds a palette variant with hues rotated by the degrees, -p adds the palette of another PNG
+ * drawn with the same layout. Both can be given more than once, in the order of the variants.
+ * -n expands every variant repeat times after writing to measure throughput.
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <png.h>
+#include "plate.h"
+
+/* Colours of a plate before quantizing, 360 x 360 has fewer */
+#define INDEX_HASH_SIZE (1 << 18)
+#define INDEX_RUN_MAX 256
+
+struct colour {
+	unsigned int rgba;
+	unsigned int count;
+};
+
+static struct index_info {
+	struct colour *hash;
+	int colours;
+
+	unsigned int palette[PLATE_COLOURS_MAX];
+	unsigned int palettes[PLATE_VARIANTS_MAX][PLATE_COLOURS_MAX];
+	int variants;
+
+	unsigned char *indices;
+	plate_run_s *runs;
+	unsigned int run_count;
+} s_info = {
+	.hash = NULL,
+	.colours = 0,
+	.variants = 0,
+
+	.indices = NULL,
+	.runs = NULL,
+	.run_count = 0,
+};
+
+/*
+ * @brief Get monotonic time in seconds
+ */
+static double _time_get(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/*
+ * @brief Decode a PNG into RGBA, caller frees
+ * @param[in] path Path of the PNG
+ * @param[out] w Width
+ * @param[out] h Height
+ */
+static unsigned int *_png_load(const char *path, int *w, int *h)
+{
+	png_image image;
+	unsigned int *rgba = NULL;
+
+	memset(&image, 0, sizeof(image));
+	image.version = PNG_IMAGE_VERSION;
+
+	if (!png_image_begin_read_from_file(&image, path)) {
+		fprintf(stderr, "%s: %s\n", path, image.message);
+		return NULL;
+	}
+
+	image.format = PNG_FORMAT_RGBA;
+	*w = (int)image.width;
+	*h = (int)image.height;
+	rgba = malloc(PNG_IMAGE_SIZE(image));
+	if (rgba == NULL) {
+		png_image_free(&image);
+		return NULL;
+	}
+
+	if (!png_image_finish_read(&image, NULL, rgba, 0, NULL)) {
+		fprintf(stderr, "%s: %s\n", path, image.message);
+		free(rgba);
+		return NULL;
+	}
+
+	return rgba;
+}
+
+/*
+ * @brief Colour channel of an RGBA pixel in memory order
+ */
+static inline int _channel(unsigned int rgba, int c)
+{
+	return ((const unsigned char *)&rgba)[c];
+}
+
+/*
+ * @brief Premultiply an RGBA pixel into the ARGB of evas image data
+ * @param[in] rgba Pixel as read by libpng
+ */
+static unsigned int _premultiply(unsigned int rgba)
+{
+	int a = _channel(rgba, 3);
+	unsigned int r = (_channel(rgba, 0) * a + 127) / 255;
+	unsigned int g = (_channel(rgba, 1) * a + 127) / 255;
+	unsigned int b = (_channel(rgba, 2) * a + 127) / 255;
+
+	return ((unsigned int)a << 24) | (r << 16) | (g << 8) | b;
+}
+
+/*
+ * @brief Squared distance of two RGBA pixels, fully transparent pixels are all the same
+ */
+static int _distance(unsigned int p, unsigned int q)
+{
+	int d = 0;
+	int c;
+
+	if (_channel(p, 3) == 0 && _channel(q, 3) == 0)
+		return 0;
+
+	for (c = 0; c < 4; c++)
+		d += (_channel(p, c) - _channel(q, c)) * (_channel(p, c) - _channel(q, c));
+
+	return d;
+}
+
+/*
+ * @brief Count the colour of a pixel in the open addressing hash
+ * @param[in] rgba Pixel
+ */
+static int _colour_count(unsigned int rgba)
+{
+	unsigned int slot = (rgba * 2654435761u) & (INDEX_HASH_SIZE - 1);
+
+	/* Every fully transparent pixel is the same colour */
+	if (_channel(rgba, 3) == 0)
+		rgba = 0;
+
+	while (s_info.hash[slot].count && s_info.hash[slot].rgba != rgba)
+		slot = (slot + 1) & (INDEX_HASH_SIZE - 1);
+
+	if (s_info.hash[slot].count == 0) {
+		if (s_info.colours == INDEX_HASH_SIZE / 2)
+			return -1;
+		s_info.hash[slot].rgba = rgba;
+		s_info.colours++;
+	}
+	s_info.hash[slot].count++;
+
+	return 0;
+}
+
+static int _colour_cmp(const void *a, const void *b)
+{
+	const struct colour *ca = a;
+	const struct colour *cb = b;
+
+	if (ca->count != cb->count)
+		return ca->count < cb->count ? 1 : -1;
+
+	return ca->rgba < cb->rgba ? -1 : ca->rgba > cb->rgba;
+}
+
+/*
+ * @brief Find the palette index of a pixel, the exact colour or the nearest one
+ * @param[in] rgba Pixel
+ * @param[in] colours Colours of the palette
+ * @param[out] error Squared distance to the palette colour
+ */
+static int _palette_find(unsigned int rgba, int colours, int *error)
+{
+	int best = 0;
+	int best_d = _distance(rgba, s_info.palette[0]);
+	int i, d;
+
+	for (i = 1; i < colours && best_d; i++) {
+		d = _distance(rgba, s_info.palette[i]);
+		if (d < best_d) {
+			best = i;
+			best_d = d;
+		}
+	}
+
+	*error = best_d;
+
+	return best;
+}
+
+/*
+ * @brief Quantize the plate to palette indices
+ * @param[in] rgba Pixels
+ * @param[in] count Number of pixels
+ * @return Number of colours in the palette
+ */
+static int _plate_index(const unsigned int *rgba, int count)
+{
+	int colours = 0;
+	int max_error = 0;
+	int lossy = 0;
+	int error;
+	int i;
+
+	s_info.hash = calloc(INDEX_HASH_SIZE, sizeof(*s_info.hash));
+	s_info.indices = malloc(count);
+	if (s_info.hash == NULL || s_info.indices == NULL)
+		return -1;
+
+	for (i = 0; i < count; i++)
+		if (_colour_count(rgba[i]))
+			return -1;
+
+	/* Pack the used slots and sort by frequency */
+	for (i = 0; i < INDEX_HASH_SIZE; i++)
+		if (s_info.hash[i].count)
+			s_info.hash[colours++] = s_info.hash[i];
+	qsort(s_info.hash, colours, sizeof(*s_info.hash), _colour_cmp);
+
+	if (colours > PLATE_COLOURS_MAX)
+		colours = PLATE_COLOURS_MAX;
+	for (i = 0; i < colours; i++)
+		s_info.palette[i] = s_info.hash[i].rgba;
+
+	for (i = 0; i < count; i++) {
+		s_info.indices[i] = (unsigned char)_palette_find(rgba[i], colours, &error);
+		if (error) {
+			lossy++;
+			if (error > max_error)
+				max_error = error;
+		}
+	}
+
+	printf("colours %d kept %d, %d pixels moved, max error %.1f\n", s_info.colours, colours, lossy, sqrt(max_error));
+
+	return colours;
+}
+
+/*
+ * @brief Store every row as runs of one index
+ * @param[in] w Width
+ * @param[in] h Height
+ */
+static int _plate_runs(int w, int h)
+{
+	const unsigned char *row = NULL;
+	int x, y, len;
+
+	s_info.runs = malloc((size_t)w * h * sizeof(*s_info.runs));
+	if (s_info.runs == NULL)
+		return -1;
+
+	for (y = 0; y < h; y++) {
+		row = s_info.indices + (size_t)y * w;
+		for (x = 0; x < w; x += len) {
+			for (len = 1; x + len < w && len < INDEX_RUN_MAX && row[x + len] == row[x]; len++)
+				;
+			s_info.runs[s_info.run_count].length = (unsigned char)(len - 1);
+			s_info.runs[s_info.run_count].index = row[x];
+			s_info.run_count++;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Add a variant with hues rotated, with the hue-rotate matrix of CSS filter effects
+ * @param[in] colours Colours of the palette
+ * @param[in] degrees Rotation
+ */
+static void _variant_add_hue(int colours, double degrees)
+{
+	double c = cos(degrees * M_PI / 180.0);
+	double s = sin(degrees * M_PI / 180.0);
+	double m[3][3] = {
+		{ 0.213 + c * 0.787 - s * 0.213, 0.715 - c * 0.715 - s * 0.715, 0.072 - c * 0.072 + s * 0.928 },
+		{ 0.213 - c * 0.213 + s * 0.143, 0.715 + c * 0.285 + s * 0.140, 0.072 - c * 0.072 - s * 0.283 },
+		{ 0.213 - c * 0.213 - s * 0.787, 0.715 - c * 0.715 + s * 0.715, 0.072 + c * 0.928 + s * 0.072 },
+	};
+	unsigned char out[4];
+	double v;
+	int i, k, j;
+
+	for (i = 0; i < colours; i++) {
+		for (k = 0; k < 3; k++) {
+			v = 0.0;
+			for (j = 0; j < 3; j++)
+				v += m[k][j] * _channel(s_info.palette[i], j);
+			out[k] = v <= 0.0 ? 0 : (v >= 255.0 ? 255 : (unsigned char)(v + 0.5));
+		}
+		out[3] = _channel(s_info.palette[i], 3);
+		s_info.palettes[s_info.variants][i] = _premultiply(out[0] | out[1] << 8 | out[2] << 16 | (unsigned int)out[3] << 24);
+	}
+
+	s_info.variants++;
+}
+
+/*
+ * @brief Add the palette of a PNG drawn with the same layout
+ * Each index takes the colour of the variant where the plate has the exact palette colour
+ * @param[in] path Path of the variant PNG
+ * @param[in] rgba Pixels of the plate
+ * @param[in] w Width of the plate
+ * @param[in] h Height of the plate
+ * @param[in] colours Colours of the palette
+ */
+static int _variant_add_png(const char *path, const unsigned int *rgba, int w, int h, int colours)
+{
+	unsigned int *variant = NULL;
+	unsigned char seen[PLATE_COLOURS_MAX] = { 0, };
+	int vw, vh;
+	int mismatch = 0;
+	int i, index;
+
+	variant = _png_load(path, &vw, &vh);
+	if (variant == NULL)
+		return -1;
+
+	if (vw != w || vh != h) {
+		fprintf(stderr, "%s: %dx%d, plate is %dx%d\n", path, vw, vh, w, h);
+		free(variant);
+		return -1;
+	}
+
+	for (i = 0; i < w * h; i++) {
+		index = s_info.indices[i];
+		if (_distance(rgba[i], s_info.palette[index]))
+			continue;
+
+		if (!seen[index]) {
+			seen[index] = 1;
+			s_info.palettes[s_info.variants][index] = _premultiply(variant[i]);
+		} else if (s_info.palettes[s_info.variants][index] != _premultiply(variant[i])) {
+			mismatch++;
+		}
+	}
+	free(variant);
+
+	for (i = 0; i < colours; i++)
+		if (!seen[i])
+			s_info.palettes[s_info.variants][i] = s_info.palettes[0][i];
+
+	if (mismatch)
+		fprintf(stderr, "%s: %d pixels do not follow the layout of the plate\n", path, mismatch);
+
+	s_info.variants++;
+
+	return 0;
+}
+
+/*
+ * @brief Write the plate file
+ * @param[in] path Path of the plate
+ * @param[in] w Width
+ * @param[in] h Height
+ * @param[in] colours Colours of every palette
+ */
+static int _plate_write(const char *path, int w, int h, int colours)
+{
+	plate_header_s header = {
+		.magic = PLATE_MAGIC,
+		.version = PLATE_VERSION,
+		.width = (unsigned short)w,
+		.height = (unsigned short)h,
+		.colours = (unsigned short)colours,
+		.variants = (unsigned short)s_info.variants,
+		.reserved = 0,
+		.runs = s_info.run_count,
+	};
+	FILE *fp = NULL;
+	int v;
+	int ret = 0;
+
+	fp = fopen(path, "wb");
+	if (fp == NULL) {
+		perror(path);
+		return -1;
+	}
+
+	if (fwrite(&header, sizeof(header), 1, fp) != 1)
+		ret = -1;
+	for (v = 0; v < s_info.variants && !ret; v++)
+		if (fwrite(s_info.palettes[v], sizeof(unsigned int), colours, fp) != (size_t)colours)
+			ret = -1;
+	if (!ret && fwrite(s_info.runs, sizeof(*s_info.runs), s_info.run_count, fp) != s_info.run_count)
+		ret = -1;
+
+	if (fclose(fp) || ret) {
+		fprintf(stderr, "%s: write failed\n", path);
+		return -1;
+	}
+
+	printf("%s: %dx%d, %d variants, %u runs, %ld bytes\n", path, w, h, s_info.variants, s_info.run_count,
+			(long)(sizeof(header) + (size_t)s_info.variants * colours * sizeof(unsigned int)
+					+ s_info.run_count * sizeof(*s_info.runs)));
+
+	return 0;
+}
+
+/*
+ * @brief Expand the written plate repeat times for every variant
+ * @param[in] path Path of the plate
+ * @param[in] repeat Number of expansions per variant
+ */
+static int _plate_bench(const char *path, int repeat)
+{
+	plate_s plate;
+	unsigned int *dst = NULL;
+	double start, elapsed;
+	int i, v;
+
+	if (plate_open(&plate, path)) {
+		fprintf(stderr, "%s: does not open\n", path);
+		return -1;
+	}
+
+	dst = malloc((size_t)plate.header->width * plate.header->height * sizeof(*dst));
+	if (dst == NULL) {
+		plate_close(&plate);
+		return -1;
+	}
+
+	start = _time_get();
+	for (i = 0; i < repeat; i++)
+		for (v = 0; v < plate.header->variants; v++)
+			plate_expand(&plate, v, dst, plate.header->width);
+	elapsed = _time_get() - start;
+
+	printf("expand %.3f ms/plate, %.0f Mpx/s\n", elapsed * 1000.0 / ((double)repeat * plate.header->variants),
+			(double)repeat * plate.header->variants * plate.header->width * plate.header->height / elapsed / 1000000.0);
+
+	free(dst);
+	plate_close(&plate);
+
+	return 0;
+}
+
+static void _usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-o plate.gip] [-r degrees] [-p variant.png] [-n repeat] plate.png\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *variant_args[PLATE_VARIANTS_MAX] = { NULL, };
+	char variant_types[PLATE_VARIANTS_MAX] = { 0, };
+	char out_path[PATH_MAX] = { 0, };
+	const char *out = NULL;
+	unsigned int *rgba = NULL;
+	char *dot = NULL;
+	int variant_count = 1;
+	int repeat = 0;
+	int colours;
+	int w, h;
+	int opt;
+	int i;
+
+	while ((opt = getopt(argc, argv, "o:r:p:n:h")) != -1) {
+		switch (opt) {
+		case 'o':
+			out = optarg;
+			break;
+		case 'r':
+		case 'p':
+			if (variant_count == PLATE_VARIANTS_MAX) {
+				fprintf(stderr, "at most %d variants\n", PLATE_VARIANTS_MAX);
+				return 2;
+			}
+			variant_types[variant_count] = (char)opt;
+			variant_args[variant_count++] = optarg;
+			break;
+		case 'n':
+			repeat = atoi(optarg);
+			break;
+		default:
+			_usage(argv[0]);
+			return 2;
+		}
+	}
+
+	if (optind != argc - 1) {
+		_usage(argv[0]);
+		return 2;
+	}
+
+	if (out == NULL) {
+		snprintf(out_path, sizeof(out_path) - sizeof(PLATE_SUFFIX), "%s", argv[optind]);
+		dot = strrchr(out_path, '.');
+		if (dot)
+			*dot = '\0';
+		strcat(out_path, PLATE_SUFFIX);
+		out = out_path;
+	}
+
+	rgba = _png_load(argv[optind], &w, &h);
+	if (rgba == NULL)
+		return 1;
+
+	if (w > 0xffff || h > 0xffff) {
+		fprintf(stderr, "%s: %dx%d is too large\n", argv[optind], w, h);
+		return 1;
+	}
+
+	colours = _plate_index(rgba, w * h);
+	if (colours <= 0 || _plate_runs(w, h))
+		return 1;
+
+	for (i = 0; i < colours; i++)
+		s_info.palettes[0][i] = _premultiply(s_info.palette[i]);
+	s_info.variants = 1;
+
+	for (i = 1; i < variant_count; i++) {
+		if (variant_types[i] == 'r')
+			_variant_add_hue(colours, atof(variant_args[i]));
+		else if (_variant_add_png(variant_args[i], rgba, w, h, colours))
+			return 1;
+	}
+
+	if (_plate_write(out, w, h, colours))
+		return 1;
+
+	if (repeat > 0 && _plate_bench(out, repeat))
+		return 1;
+
+	return 0;
+}